@@ -47,17 +47,24 @@ class Progress {
 protected:
     size_t cur, total;
     time_t last_report;
-    bool is_terminal, force, had_output;
+    bool is_terminal, force, had_output, with_rate;
+    size_t start_cur;                           // value of cur when the rate measurement started
+    double start_time;                          // when the rate measurement started, seconds since the epoch
     std::string mesg;
     enum { WIDTH=100, RPT_INTERVAL=1 };
     void init();
 public:
-    Progress(size_t total): cur(0), total(total), last_report(0), is_terminal(false), force(false), had_output(false) { init(); }
+    Progress(size_t total)
+        : cur(0), total(total), last_report(0), is_terminal(false), force(false), had_output(false), with_rate(false),
+          start_cur(0), start_time(0) { init(); }
     ~Progress() { clear(); }
 
     /** Force the progress bar to be emitted even if standard error is not a terminal. */
     void force_output(bool b) { force = b; }
 
+    /** Append the rate (increments per second since the counter was last reset) to the progress bar. */
+    void show_rate(bool b) { with_rate = b; }
+
     /** Increment the progress. The bar is updated only if it's been at least RPT_INTERVAL seconds since the previous update
      *  or if @p update_now is true.
      *  @{ */
@@ -85,6 +92,9 @@ public:
 
     /** Returns the current position. */
     size_t current() const { return cur; }
+
+    /** Returns the number of increments per second since the counter was last reset. */
+    double rate() const;
 };
 
 
@@ -105,6 +115,7 @@ public:
         SMTSOLVER   = 911000006,     /**< Some fault in the SMT solver. */
         INPUT_LIMIT = 911000007,     /**< Too many input values consumed. */
         BAD_STACK   = 911000008,     /**< ESP is above the starting point. */
+        TIMEOUT     = 911000009,     /**< Test was killed after running longer than the wall-clock limit. */
         // don't forget to fix 00-create-schema.C and the functions below
     };
 
@@ -120,6 +131,7 @@ public:
             case SMTSOLVER:     return "SMT solver";
             case INPUT_LIMIT:   return "input limit";
             case BAD_STACK:     return "bad stack ptr";
+            case TIMEOUT:       return "timeout";
             default:
                 assert(!"fault not handled");
                 abort();
@@ -138,6 +150,7 @@ public:
             case SMTSOLVER:     return "SMT solver error";
             case INPUT_LIMIT:   return "over-consumption of input values";
             case BAD_STACK:     return "stack pointer is above analysis starting point";
+            case TIMEOUT:       return "test exceeded the wall-clock time limit";
             default:
                 assert(!"fault not handled");
                 abort();
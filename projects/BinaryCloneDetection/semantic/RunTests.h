@@ -20,7 +20,7 @@ struct Switches {
     Switches()
         : verbosity(SILENT), progress(false), pointers(false), interactive(false), trace_events(0), dry_run(false),
           save_coverage(false), save_callgraph(false), save_consumed_inputs(false), nprocs(1),
-          path_syntactic(PATH_SYNTACTIC_NONE) {
+          path_syntactic(PATH_SYNTACTIC_NONE), fork_server(false), test_timeout(0), batch_size(100) {
         checkpoint = 300 + LinearCongruentialGenerator()()%600;
     }
     Verbosity verbosity;                        // semantic policy has a separate verbosity
@@ -38,6 +38,9 @@ struct Switches {
     size_t nprocs;                                      // number of parallel processes to fork
     std::vector<std::string> signature_components;      /**< How should the signature vectors be computed */
     PathSyntactic path_syntactic;                       /**< How to compute path sensistive syntactic signature */
+    bool fork_server;                                   /**< Run tests in a pool of persistent worker processes */
+    time_t test_timeout;                                /**< Wall-clock limit per test in seconds, or zero (fork server) */
+    size_t batch_size;                                  /**< Number of results per database write (fork server) */
 };
 
 struct WorkItem {
@@ -50,6 +53,40 @@ struct WorkItem {
 
 std::ostream& operator<<(std::ostream&, const WorkItem&);
 
+/** One row of the semantic_fio table, the result of one test. */
+struct FioRow {
+    int func_id, igroup_id;
+    size_t arguments_consumed, locals_consumed, globals_consumed, functions_consumed, pointers_consumed, integers_consumed;
+    size_t instructions_executed;
+    int64_t ogroup_id;
+    int status;                                         // an AnalysisFault::Fault
+    double elapsed_time, cpu_time;
+    int64_t cmd_id;
+    std::string counts_b64;
+    int syntactic_ninsns;
+    FioRow()
+        : func_id(-1), igroup_id(-1), arguments_consumed(0), locals_consumed(0), globals_consumed(0), functions_consumed(0),
+          pointers_consumed(0), integers_consumed(0), instructions_executed(0), ogroup_id(-1), status(AnalysisFault::NONE),
+          elapsed_time(0), cpu_time(0), cmd_id(-1), syntactic_ninsns(0) {}
+};
+
+/** Rows of the semantic_fio table that are written to the database together.  When the batch is flushed the rows are
+ *  inserted with multi-row "insert ... values (...), (...), ..." statements of up to 500 rows each, which is much cheaper
+ *  than one statement per test. */
+class FioBatch {
+public:
+    void insert(const FioRow &row) { rows.push_back(row); }
+    bool empty() const { return rows.empty(); }
+    size_t size() const { return rows.size(); }
+    void clear() { rows.clear(); }
+
+    /** Insert all pending rows into the database and clear the batch. */
+    void flush(const SqlDatabase::TransactionPtr&);
+
+private:
+    std::vector<FioRow> rows;
+};
+
 typedef std::vector<WorkItem> Work;
 typedef std::vector<Work> MultiWork;
 typedef std::map<SgAsmFunction*, PointerDetector*> PointerDetectors;
@@ -84,6 +121,15 @@ void runOneTest(SqlDatabase::TransactionPtr tx, const WorkItem &workItem, Pointe
                 FuncAnalyses funcinfo, const InstructionProvidor &insns, MemoryMap *ro_map, const AddressIdMap &entry2id,
                 OutputGroups &ogroups /*in,out*/);
 
+/** Same as above except the semantic_fio row is returned instead of being inserted into the database. */
+FioRow runOneTest(const WorkItem &workItem, PointerDetectors &pointers, SgAsmFunction *func,
+                  const FunctionIdMap &function_ids, InsnCoverage &insn_coverage /*in,out*/,
+                  DynamicCallGraph &dynamic_cg /*in,out*/, Tracer &tracer /*in,out*/,
+                  ConsumedInputs &consumed_inputs /*in,out*/, SgAsmInterpretation *interp,
+                  const rose::BinaryAnalysis::Disassembler::AddressSet &whitelist_exports, int64_t cmd_id, InputGroup &igroup,
+                  FuncAnalyses funcinfo, const InstructionProvidor &insns, MemoryMap *ro_map, const AddressIdMap &entry2id,
+                  OutputGroups &ogroups /*in,out*/);
+
 } // namespace
 } // namespace
 
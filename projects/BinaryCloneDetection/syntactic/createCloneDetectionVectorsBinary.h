@@ -3,6 +3,7 @@
 
 #include "rose.h"
 #include "SqlDatabase.h"
+#include "signatureVectorSink.h"
 
 #include <deque>
 #include <fstream>
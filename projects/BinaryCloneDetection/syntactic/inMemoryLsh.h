@@ -0,0 +1,119 @@
+#ifndef IN_MEMORY_LSH_H
+#define IN_MEMORY_LSH_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+// Information about a window that is needed to write the clusters and their rows of the "vectors" table.
+struct WindowInfo {
+    uint32_t functionId;
+    uint32_t indexWithinFunction;
+    uint64_t line;                      // address of the first instruction
+    uint64_t lastInsnVa;                // address of the last instruction
+    uint32_t size;                      // number of bytes covered by the instructions
+    uint32_t sumOfCounts;
+    unsigned char instrSeqMD5[16];      // MD5 of the normalized instructions
+};
+
+// Feature vectors of all windows, held in memory.
+//
+// Vectors are appended in compressed form (see vectorCompression.h) as they stream in from the disassembler. finalize()
+// then decompresses them into one dense matrix that is restricted to the elements that are nonzero in at least one vector
+// (most elements of a SignatureVector are zero for every x86 window), with each row padded to a multiple of eight elements
+// for the SIMD distance kernels. Vectors with identical counts are collapsed: only the first of them (the representative)
+// is put into the matrix.
+class DenseVectorTable {
+public:
+    explicit DenseVectorTable(size_t numVectorElements);
+
+    // Appends a vector of numVectorElements elements.
+    void add(const uint16_t vec[], const WindowInfo&);
+
+    // Builds the dense matrix; no vectors can be added afterward.
+    void finalize();
+
+    // Number of vectors that were added
+    size_t size() const { return infos.size(); }
+
+    const WindowInfo& info(size_t i) const { return infos[i]; }
+    const uint8_t* compressed(size_t i) const { return &compressedData[compressedOffsets[i]]; }
+    size_t compressed_size(size_t i) const { return compressedOffsets[i+1] - compressedOffsets[i]; }
+
+    // The following are valid after finalize()
+
+    // Vector number of the representative of vector i (the first vector with the same counts)
+    size_t representative(size_t i) const { return representatives[i]; }
+
+    // Vectors in the matrix, and the duplicates of each of them
+    size_t num_rows() const { return rowVectors.size(); }
+    size_t row_vector(size_t row) const { return rowVectors[row]; }
+    const std::vector<uint32_t>& row_duplicates(size_t row) const { return duplicates[row]; }
+
+    // Number of (nonzero) elements per row, and the padded number of elements per row
+    size_t num_elements() const { return upperBounds.size(); }
+    size_t row_stride() const { return stride; }
+    const uint16_t* row(size_t row) const { return &matrix[row * stride]; }
+
+    // Largest value of each element over all vectors
+    uint16_t upper_bound(size_t element) const { return upperBounds[element]; }
+
+private:
+    size_t numVectorElements;
+    std::vector<WindowInfo> infos;
+    std::vector<uint8_t> compressedData;
+    std::vector<size_t> compressedOffsets;
+    std::vector<uint16_t> maxima;               // elementwise maximum of all added vectors (all elements)
+
+    std::vector<uint32_t> representatives;
+    std::vector<uint32_t> rowVectors;
+    std::vector<std::vector<uint32_t> > duplicates;
+    std::vector<uint16_t> upperBounds;          // maxima of the elements in the matrix
+    size_t stride;
+    std::vector<uint16_t> matrix;
+};
+
+// Locality sensitive hash index over some rows of a DenseVectorTable (one group of vectors, see computerangesFunc.h).
+//
+// Like HammingHashFunctionSet, each of the l hash functions samples k bits of the unary (Hamming) embedding of the vectors:
+// a bit tests whether an element exceeds a threshold, and the elements and thresholds are drawn uniformly from the total
+// range of the elements over the indexed rows. Each hash table is an array of (hash, row) pairs sorted by hash. The tables are built in parallel
+// and query() can be called from several threads; candidates are checked with l1distanceDense or l2distanceSquaredDense.
+class InMemoryLshIndex {
+public:
+    // Indexes the given rows, which must be in increasing order
+    InMemoryLshIndex(const DenseVectorTable&, const std::vector<uint32_t>& rows, size_t k, size_t l, int norm);
+
+    // Appends the indexed rows (other than row) within distBound of row to result, as pairs of row number and distance.
+    void query(size_t row, double distBound, std::vector<std::pair<size_t, double> >& result) const;
+
+    double distance(size_t row1, size_t row2) const;
+
+private:
+    struct Entry {
+        uint64_t hash;
+        uint32_t row;
+        bool operator<(const Entry& other) const { return hash < other.hash || (hash == other.hash && row < other.row); }
+    };
+
+    uint64_t compute_hash(size_t function, const uint16_t vec[]) const;
+
+    const DenseVectorTable& vectors;
+    size_t k, l;
+    int norm;
+    std::vector<uint32_t> sampleElements;       // l*k sampled elements, sorted within each hash function
+    std::vector<uint16_t> sampleThresholds;
+    std::vector<uint64_t> sampleCoeffs;
+    std::vector<std::vector<Entry> > tables;
+};
+
+// Clusters the rows of one group in the same way as lshCloneDetection: the rows are visited in order and each row that is
+// not yet in a cluster forms a cluster with all later rows within distBound that are not yet in a cluster. The rows must be
+// those that the index was built from. The neighbors of the rows are computed in parallel, a block of rows at a time. The
+// clusters are appended to the list; each is a list of pairs of vector number and distance and includes the duplicates of
+// its rows. Clusters of a single vector are not returned.
+void find_clusters(const DenseVectorTable&, const InMemoryLshIndex&, const std::vector<uint32_t>& rows, double distBound,
+                   std::vector<std::vector<std::pair<size_t, double> > >& clusters);
+
+#endif
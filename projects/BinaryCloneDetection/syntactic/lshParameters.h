@@ -0,0 +1,24 @@
+#ifndef LSH_PARAMETERS_H
+#define LSH_PARAMETERS_H
+
+#include <cstddef>
+
+// LSH parameters of one group of vectors (see computerangesFunc.h)
+struct parameters {
+    size_t k;                           // number of elements in a single hash function
+    size_t l;                           // number of hash tables
+    size_t num_buckets;
+    size_t num_elem_per_bucket;
+
+    parameters(size_t kVal, size_t lVal, size_t num_bucketsVal, size_t num_elem_per_bucketVal)
+        : k(kVal), l(lVal), num_buckets(num_bucketsVal), num_elem_per_bucket(num_elem_per_bucketVal)
+        {};
+};
+
+// Chooses k and l for a group of num_vectors vectors whose sums of counts are at least groupLow, so that clone pairs are
+// missed with at most the false negative rate and the hash tables fit in the available memory.
+parameters
+selectParameters(double false_negative_rate, double similarity_threshold, int groupLow, int num_elem_per_bucket,
+                 int num_vectors,  int norm, size_t available_memory=1600000000);
+
+#endif
@@ -0,0 +1,29 @@
+#ifndef SIGNATURE_VECTOR_SINK_H
+#define SIGNATURE_VECTOR_SINK_H
+
+#include <string>
+#include <cstddef>
+
+class SgNode;
+class SgAsmX86Instruction;
+class SignatureVector;
+
+// Receives the signature vectors of the sliding windows as they are generated, so that the vectors can be stored in the
+// database ("vectors" table) or be clustered in memory without a round trip through SQL (see findClonesInMemory).
+class SignatureVectorSink {
+public:
+    virtual ~SignatureVectorSink() {}
+
+    // Called once for each window; firstInsn points to the windowSize instructions of the window.
+    virtual void add_vector(const SignatureVector& vec, const std::string& functionName, size_t functionId,
+                            size_t indexWithinFunction, const std::string& normalizedUnparsedInstructions,
+                            SgAsmX86Instruction* firstInsn[], size_t windowSize) = 0;
+
+    // Called once for each function after all of its windows.
+    virtual void add_function(const std::string& /*functionName*/, size_t /*functionId*/, size_t /*numInstructions*/) {}
+};
+
+bool createVectorsForAllInstructions(SgNode* top, const std::string& functionName, int functionId, size_t windowSize,
+                                     size_t stride, SignatureVectorSink&);
+
+#endif
@@ -3,6 +3,7 @@
 
 #include <vector>
 #include <stdint.h>
+#include <cstddef>
 
 std::vector<uint8_t> compressVector(const uint16_t data[], const size_t dataSize);
 void decompressVector(const uint8_t compressedData[], size_t compressedDataSize, uint16_t result[]);
@@ -18,4 +19,8 @@ double l2distanceSquaredC(const uint8_t compressedData[], const size_t compresse
 void elementwiseMax(const uint8_t compressedData[], size_t compressedDataSize, uint16_t v[]);
 size_t computeL1Hash(const uint8_t compressedData[], size_t compressedDataSize, size_t hashElementCount, const size_t indexes[], const size_t compareValues[], const size_t coeffs[], size_t moduloValue);
 
+// Distances between two uncompressed vectors of n elements; these use SSE2 when the compiler supports it.
+size_t l1distanceDense(const uint16_t a[], const uint16_t b[], size_t n);
+uint64_t l2distanceSquaredDense(const uint16_t a[], const uint16_t b[], size_t n);
+
 #endif // VECTORCOMPRESSION_H
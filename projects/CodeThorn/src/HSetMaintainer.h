@@ -11,7 +11,7 @@
 #include "HSet.h"
 using namespace br_stl;
 #else
-#include <boost/unordered_set.hpp>
+#include "ShardedHSet.h"
 #endif
 
 //#include "/usr/include/valgrind/memcheck.h"
@@ -26,7 +26,7 @@ class HSetMaintainer
 #ifdef USE_CUSTOM_HSET
   : public HSet<KeyType*,HashFun,EqualToPred>
 #else
-  : public boost::unordered_set<KeyType*,HashFun,EqualToPred>
+  : public ShardedHSet<KeyType*,HashFun,EqualToPred>
 #endif
   {
 public:
@@ -39,7 +39,7 @@ public:
 #ifdef USE_CUSTOM_HSET
     typename HSet<KeyType*,HashFun,EqualToPred>::const_iterator i;
 #else
-    typename boost::unordered_set<KeyType*,HashFun,EqualToPred>::const_iterator i;
+    typename ShardedHSet<KeyType*,HashFun,EqualToPred>::const_iterator i;
 #endif
     i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
     if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
@@ -48,7 +48,7 @@ public:
 #ifdef USE_CUSTOM_HSET
       typename HSet<KeyType*,HashFun,EqualToPred>::const_iterator b;
 #else
-      typename boost::unordered_set<KeyType*,HashFun,EqualToPred>::const_iterator b;
+      typename ShardedHSet<KeyType*,HashFun,EqualToPred>::const_iterator b;
 #endif
       b=HSetMaintainer<KeyType,HashFun,EqualToPred>::begin();
       while(b!=i) {
@@ -64,54 +64,45 @@ public:
   typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
 
   KeyType* determine(KeyType& s) { 
+#ifdef USE_CUSTOM_HSET
     KeyType* ret=0;
     typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
 #pragma omp critical(HASHSET)
     {
-#ifdef USE_CUSTOM_HSET
       i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
       if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
         ret=const_cast<KeyType*>(&(*i));
       } else {
         ret=0;
       }
-#else
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(&s);
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=const_cast<KeyType*>(*i);
-      } else {
-        ret=0;
-      }
-#endif
     }
     return ret;
+#else
+    return this->lookup(&s);
+#endif
   }
 
   const KeyType* determine(const KeyType& s) { 
+#ifdef USE_CUSTOM_HSET
     const KeyType* ret=0;
     typename HSetMaintainer<KeyType,HashFun,EqualToPred>::iterator i;
 #pragma omp critical(HASHSET)
     {
-#ifdef USE_CUSTOM_HSET
       i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(s);
       if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
         ret=&(*i);
       } else {
         ret=0;
       }
-#else
-      i=HSetMaintainer<KeyType,HashFun,EqualToPred>::find(const_cast<KeyType*>(&s));
-      if(i!=HSetMaintainer<KeyType,HashFun,EqualToPred>::end()) {
-        ret=const_cast<KeyType*>(*i);
-      } else {
-        ret=0;
-      }
-#endif
     }
     return ret;
+#else
+    return this->lookup(const_cast<KeyType*>(&s)); // TODO: eliminate const_cast
+#endif
   }
 
   ProcessingResult process(const KeyType* key) {
+#ifdef USE_CUSTOM_HSET
     ProcessingResult res2;
 #pragma omp critical(HASHSET)
     {
@@ -126,6 +117,11 @@ public:
       res2=make_pair(res.second,*res.first);
     }
     return res2;
+#else
+    // only the shard of the key is locked
+    std::pair<KeyType*,bool> res=this->findOrInsert(const_cast<KeyType*>(key)); // TODO: eliminate const_cast
+    return make_pair(res.second,res.first);
+#endif
   }
   const KeyType* processNewOrExisting(const KeyType* s) {
     ProcessingResult res=process(s);
@@ -135,6 +131,7 @@ public:
   //! <true,const KeyType> if new element was inserted
   //! <false,const KeyType> if element already existed
   ProcessingResult process(KeyType key) {
+#ifdef USE_CUSTOM_HSET
     ProcessingResult res2;
 #pragma omp critical(HASHSET)
     {
@@ -146,28 +143,37 @@ public:
     } else {
       // converting the stack allocated object to heap allocated
       // this copies the entire object
-      // TODO: this can be avoided by providing a process function with a pointer arg
-      //       this requires a more detailed result: pointer exists, alternate pointer with equal object exists, does not exist
       KeyType* keyPtr=new KeyType();
       *keyPtr=key;
       res=this->insert(keyPtr);
     }
+    res2=make_pair(res.second,*res.first);
+    }
+    return res2;
+#else
+    if(KeyType* existing=this->lookup(&key)) {
+      // found it!
+      return make_pair(false,existing);
+    }
+    // converting the stack allocated object to heap allocated
+    // this copies the entire object, which is done outside of the lock
+    KeyType* keyPtr=new KeyType();
+    *keyPtr=key;
+    std::pair<KeyType*,bool> res=this->findOrInsert(keyPtr);
+    if(!res.second) {
+      // another thread inserted an equal element in the meantime
+      delete keyPtr;
+    }
 #ifdef HSET_MAINTAINER_DEBUG_MODE
-    std::pair<typename HSetMaintainer::iterator, bool> res1;
-    res1=this->insert(key);
-    std::pair<typename HSetMaintainer::iterator, bool> res2;
-    res2=this->insert(key);
-    if(!(res1==res2)) {
+    if(this->lookup(&key)!=res.first) {
       cerr<< "Error: HsetMaintainer failed:"<<endl;
-      cerr<< "res1:"<<(*res1.first).toString()<<":"<<res1.second<<endl;
-      cerr<< "res2:"<<(*res2.first).toString()<<":"<<res2.second<<endl;
+      cerr<< "res:"<<res.first->toString()<<":"<<res.second<<endl;
       exit(1);
     }
     cerr << "HSET insert OK"<<endl;
 #endif
-    res2=make_pair(res.second,*res.first);
-    }
-    return res2;
+    return make_pair(res.second,res.first);
+#endif
   }
   const KeyType* processNew(KeyType& s) {
     //std::pair<typename HSetMaintainer::iterator, bool> res=process(s);
@@ -191,14 +197,7 @@ public:
 #ifdef USE_CUSTOM_HSET
     return HSetMaintainer<KeyType,HashFun,EqualToPred>::max_collisions();
 #else
-    //MS:2012
-    size_t max=0;
-    for(size_t i=0; i<HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_count();++i) {
-      if(HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_size(i)>max) {
-        max=HSetMaintainer<KeyType,HashFun,EqualToPred>::bucket_size(i);
-      }
-    }
-    return max;
+    return HSetMaintainer<KeyType,HashFun,EqualToPred>::maxBucketSize();
 #endif
   }
 
@@ -0,0 +1,221 @@
+#ifndef SHARDED_HSET_H
+#define SHARDED_HSET_H
+
+/*************************************************************
+ * License  : see file LICENSE in the CodeThorn distribution *
+ *************************************************************/
+
+#include <boost/unordered_set.hpp>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <cassert>
+#include <cstddef>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+/*!
+  * \brief Hash set of pointers that can be searched and extended by many threads at once.
+  *
+  * The elements are distributed by hash value over a fixed number of
+  * shards, each of which is a boost::unordered_set protected by its own
+  * OpenMP lock. Threads that look up or insert elements in different
+  * shards do not wait for each other, in contrast to a single critical
+  * section around one set. Elements are pointers to heap-allocated
+  * objects, so the pointers handed out remain valid when a shard is
+  * rehashed.
+  *
+  * Only lookup and findOrInsert may be used concurrently. All other
+  * operations (iteration, erase, clear, size statistics) have the same
+  * interface as boost::unordered_set and are meant for the sequential
+  * phases of the analysis.
+  */
+template<typename Key, typename HashFun, typename EqualToPred, size_t NumShards=64>
+class ShardedHSet {
+ public:
+  typedef boost::unordered_set<Key,HashFun,EqualToPred> shard_type;
+  typedef Key value_type;
+  typedef size_t size_type;
+
+ private:
+  // each shard is padded to a cache line to avoid false sharing of the locks
+  struct Shard {
+    shard_type set;
+#ifdef _OPENMP
+    omp_lock_t lock;
+#endif
+    char padding[64];
+    Shard() { initLock(); }
+    Shard(const Shard& other):set(other.set) { initLock(); }
+    Shard& operator=(const Shard& other) { set=other.set; return *this; }
+    ~Shard() {
+#ifdef _OPENMP
+      omp_destroy_lock(&lock);
+#endif
+    }
+    void initLock() {
+#ifdef _OPENMP
+      omp_init_lock(&lock);
+#endif
+    }
+  };
+
+  class Guard {
+  public:
+    Guard(Shard& shard):_shard(shard) {
+#ifdef _OPENMP
+      omp_set_lock(&_shard.lock);
+#endif
+    }
+    ~Guard() {
+#ifdef _OPENMP
+      omp_unset_lock(&_shard.lock);
+#endif
+    }
+  private:
+    Shard& _shard;
+  };
+
+  std::vector<Shard> _shards;
+  HashFun _hashFun;
+
+  // the hash value is mixed before selecting a shard because the
+  // pointer-based hash functions leave the low bits mostly zero
+  size_t shardIndex(const Key& key) const {
+    unsigned long long h=(unsigned long long)_hashFun(key);
+    h^=h>>29;
+    h*=0x9e3779b97f4a7c15ULL;
+    return (size_t)(h>>40)%NumShards;
+  }
+
+ public:
+  class const_iterator {
+    friend class ShardedHSet;
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef Key value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const Key* pointer;
+    typedef const Key& reference;
+
+    const_iterator():_shards(0),_shardNr(0) {}
+    reference operator*() const { return *_current; }
+    pointer operator->() const { return &*_current; }
+    const_iterator& operator++() {
+      ++_current;
+      skipEmptyShards();
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp=*this;
+      ++*this;
+      return tmp;
+    }
+    bool operator==(const const_iterator& other) const {
+      return _shardNr==other._shardNr && (_shardNr==NumShards || _current==other._current);
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this==other);
+    }
+  private:
+    const_iterator(const std::vector<Shard>* shards, size_t shardNr, typename shard_type::const_iterator current)
+      :_shards(shards),_shardNr(shardNr),_current(current) {
+      skipEmptyShards();
+    }
+    void skipEmptyShards() {
+      while(_shardNr<NumShards && _current==(*_shards)[_shardNr].set.end()) {
+        if(++_shardNr<NumShards)
+          _current=(*_shards)[_shardNr].set.begin();
+      }
+    }
+    const std::vector<Shard>* _shards;
+    size_t _shardNr;
+    typename shard_type::const_iterator _current;
+  };
+  // elements cannot be modified in place, as in boost::unordered_set
+  typedef const_iterator iterator;
+
+  ShardedHSet():_shards(NumShards) {}
+
+  //! thread-safe: returns the element equal to key, or a default constructed Key (0) if there is none
+  Key lookup(const Key& key) {
+    Shard& shard=_shards[shardIndex(key)];
+    Guard guard(shard);
+    typename shard_type::const_iterator i=shard.set.find(key);
+    return i!=shard.set.end() ? *i : Key();
+  }
+
+  //! thread-safe: inserts key unless an equal element exists.
+  //! Returns the element in the set and whether it is key itself (true) or the existing element (false).
+  std::pair<Key,bool> findOrInsert(const Key& key) {
+    Shard& shard=_shards[shardIndex(key)];
+    Guard guard(shard);
+    std::pair<typename shard_type::iterator,bool> res=shard.set.insert(key);
+    return std::make_pair(*res.first,res.second);
+  }
+
+  const_iterator begin() const {
+    return const_iterator(&_shards,0,_shards[0].set.begin());
+  }
+  const_iterator end() const {
+    return const_iterator(&_shards,NumShards,typename shard_type::const_iterator());
+  }
+  const_iterator find(const Key& key) const {
+    size_t nr=shardIndex(key);
+    typename shard_type::const_iterator i=_shards[nr].set.find(key);
+    if(i==_shards[nr].set.end())
+      return end();
+    return const_iterator(&_shards,nr,i);
+  }
+  std::pair<const_iterator,bool> insert(const Key& key) {
+    size_t nr=shardIndex(key);
+    std::pair<typename shard_type::iterator,bool> res=_shards[nr].set.insert(key);
+    return std::make_pair(const_iterator(&_shards,nr,res.first),res.second);
+  }
+  void erase(const_iterator i) {
+    assert(i._shards==&_shards && i._shardNr<NumShards);
+    _shards[i._shardNr].set.erase(i._current);
+  }
+  size_t erase(const Key& key) {
+    return _shards[shardIndex(key)].set.erase(key);
+  }
+  void clear() {
+    for(size_t i=0;i<NumShards;++i)
+      _shards[i].set.clear();
+  }
+  size_t size() const {
+    size_t n=0;
+    for(size_t i=0;i<NumShards;++i)
+      n+=_shards[i].set.size();
+    return n;
+  }
+  bool empty() const {
+    return size()==0;
+  }
+
+  //! largest number of elements in one bucket of any shard
+  size_t maxBucketSize() const {
+    size_t max=0;
+    for(size_t i=0;i<NumShards;++i) {
+      for(size_t b=0;b<_shards[i].set.bucket_count();++b) {
+        if(_shards[i].set.bucket_size(b)>max)
+          max=_shards[i].set.bucket_size(b);
+      }
+    }
+    return max;
+  }
+  float load_factor() const {
+    size_t nBuckets=0;
+    for(size_t i=0;i<NumShards;++i)
+      nBuckets+=_shards[i].set.bucket_count();
+    return nBuckets ? (float)size()/nBuckets : 0.0f;
+  }
+  void max_load_factor(float z) {
+    for(size_t i=0;i<NumShards;++i)
+      _shards[i].set.max_load_factor(z);
+  }
+  size_t numberOfShards() const { return NumShards; }
+};
+
+#endif
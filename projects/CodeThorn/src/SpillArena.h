@@ -0,0 +1,122 @@
+#ifndef SPILL_ARENA_H
+#define SPILL_ARENA_H
+
+/*************************************************************
+ * License  : see file LICENSE in the CodeThorn distribution *
+ *************************************************************/
+
+#include <string>
+#include <vector>
+#include <cstddef>
+#include <new>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace CodeThorn {
+
+/*!
+  * \brief Memory for states that is backed by files instead of swap space.
+  *
+  * When enabled (codethorn option --spill-dir), the objects that make up
+  * the state space (the EStates and the chunks of the PStates) are
+  * allocated in segment files that are memory-mapped as shared
+  * mappings. The operating system keeps the recently used (hot) pages in
+  * memory and writes cold pages back to the segment files when memory
+  * becomes scarce, hence the state space can grow beyond the size of
+  * main memory without swap space. The hash sets that index the states
+  * remain in main memory and all states are accessed through the same
+  * pointers as without spilling.
+  *
+  * Segments are appended as needed and never shrink. The disk space of a
+  * segment is reserved when it is created, so a full disk is reported
+  * as an error when a segment is added rather than by a SIGBUS when a
+  * page is written back. Freed blocks are kept in free lists by size
+  * and reused. Segment files are unlinked right after they are mapped,
+  * so they are removed when the analyzer terminates.
+  *
+  * allocate and deallocate are thread-safe.
+  */
+class SpillArena {
+ public:
+  //! enables spilling to segment files in the given directory. Must be called before any state is created.
+  static void enable(std::string directory, size_t segmentSize=defaultSegmentSize);
+  static bool isEnabled() { return _arena!=0; }
+  //! allocates from the segment files if spilling is enabled, otherwise from the heap
+  static void* allocate(size_t size);
+  //! size must be the size that was passed to allocate
+  static void deallocate(void* p, size_t size);
+  //! number of bytes of all segments (mapped address space)
+  static size_t mappedBytes();
+  //! number of bytes allocated in segments and not freed
+  static size_t usedBytes();
+  static size_t numberOfSegments();
+
+  static const size_t defaultSegmentSize=(size_t)1<<30;
+  //! larger blocks are always allocated on the heap
+  static const size_t maxBlockSize=4096;
+
+ private:
+  static const size_t alignment=16;
+  struct FreeBlock {
+    FreeBlock* next;
+  };
+  SpillArena(std::string directory, size_t segmentSize);
+  ~SpillArena();
+  void* allocateBlock(size_t size);
+  bool deallocateBlock(void* p, size_t size);
+  bool contains(void* p) const;
+  void addSegment();
+  void lock();
+  void unlock();
+
+  static SpillArena* _arena;
+  std::string _directory;
+  size_t _segmentSize;
+  std::vector<char*> _segments;
+  char* _next;
+  char* _end;
+  std::vector<FreeBlock*> _freeLists;
+  size_t _usedBytes;
+#ifdef _OPENMP
+  omp_lock_t _lock;
+#endif
+};
+
+/*!
+  * \brief STL allocator that allocates from the SpillArena.
+  */
+template<typename T>
+class SpillAllocator {
+ public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef size_t size_type;
+  typedef ptrdiff_t difference_type;
+  template<typename U> struct rebind {
+    typedef SpillAllocator<U> other;
+  };
+
+  SpillAllocator() {}
+  template<typename U> SpillAllocator(const SpillAllocator<U>&) {}
+  pointer address(reference x) const { return &x; }
+  const_pointer address(const_reference x) const { return &x; }
+  pointer allocate(size_type n, const void* =0) {
+    return static_cast<pointer>(SpillArena::allocate(n*sizeof(T)));
+  }
+  void deallocate(pointer p, size_type n) {
+    SpillArena::deallocate(p,n*sizeof(T));
+  }
+  size_type max_size() const { return size_t(-1)/sizeof(T); }
+  void construct(pointer p, const T& val) { new(static_cast<void*>(p)) T(val); }
+  void destroy(pointer p) { p->~T(); }
+  bool operator==(const SpillAllocator&) const { return true; }
+  bool operator!=(const SpillAllocator&) const { return false; }
+};
+
+} // end of namespace CodeThorn
+
+#endif
@@ -13,11 +13,16 @@
 #include <set>
 #include <map>
 #include <utility>
+#include <vector>
+#include <iterator>
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
 #include "Labeler.h"
 #include "CFAnalysis.h"
 #include "AType.h"
 #include "VariableIdMapping.h"
 #include "ConstraintRepresentation.h"
+#include "SpillArena.h"
 
 using namespace std;
 
@@ -39,11 +44,84 @@ namespace CodeThorn {
 /*! 
   * \author Markus Schordan
   * \date 2012.
+  * \brief Program state: maps each variable to its abstract value.
+  * \details The (variable,value) pairs are kept sorted by VariableId in
+  * chunks of at most maxChunkSize elements. Chunks are shared between
+  * copies of a PState and are only copied when a copy modifies one of
+  * their variables (copy-on-write). Hence, the successor of a state
+  * that differs in one variable shares all chunks but one with its
+  * predecessor. Each chunk caches the hash of its elements, so hashing
+  * a successor state only rehashes the modified chunks.
+  *
+  * A PState can be used like a map<VariableId,CppCapsuleAValue> with
+  * the exception that elements cannot be modified through iterators.
+  * A reference returned by operator[] is only valid until the PState is
+  * modified or copied.
  */
-class PState : public map<VariableId,CodeThorn::CppCapsuleAValue> {
+class PState {
  public:
-    PState() {
+  typedef VariableId key_type;
+  typedef CodeThorn::CppCapsuleAValue mapped_type;
+  typedef pair<VariableId,CodeThorn::CppCapsuleAValue> value_type;
+  typedef size_t size_type;
+ private:
+  struct Chunk {
+    typedef vector<value_type,SpillAllocator<value_type> > Elements;
+    Chunk():hash(0),hashIsValid(false) {}
+    Elements elements;
+    long hash;
+    bool hashIsValid;
+    // chunks are spilled to disk together with the EStates (see SpillArena)
+    static void* operator new(size_t size) { return SpillArena::allocate(size); }
+    static void operator delete(void* p, size_t size) { SpillArena::deallocate(p,size); }
+  };
+  typedef boost::shared_ptr<Chunk> ChunkPtr;
+ public:
+  class const_iterator {
+    friend class PState;
+  public:
+    typedef std::forward_iterator_tag iterator_category;
+    typedef PState::value_type value_type;
+    typedef ptrdiff_t difference_type;
+    typedef const value_type* pointer;
+    typedef const value_type& reference;
+    const_iterator():_chunks(0),_chunkNr(0),_elementNr(0) {}
+    reference operator*() const { return (*_chunks)[_chunkNr]->elements[_elementNr]; }
+    pointer operator->() const { return &**this; }
+    const_iterator& operator++() {
+      if(++_elementNr==(*_chunks)[_chunkNr]->elements.size()) {
+        ++_chunkNr;
+        _elementNr=0;
+      }
+      return *this;
+    }
+    const_iterator operator++(int) {
+      const_iterator tmp=*this;
+      ++*this;
+      return tmp;
     }
+    bool operator==(const const_iterator& other) const {
+      return _chunkNr==other._chunkNr && _elementNr==other._elementNr;
+    }
+    bool operator!=(const const_iterator& other) const {
+      return !(*this==other);
+    }
+  private:
+    const_iterator(const vector<ChunkPtr>* chunks, size_t chunkNr, size_t elementNr)
+      :_chunks(chunks),_chunkNr(chunkNr),_elementNr(elementNr) {}
+    const vector<ChunkPtr>* _chunks;
+    size_t _chunkNr;
+    size_t _elementNr;
+  };
+  // elements cannot be modified through iterators because chunks may be shared
+  typedef const_iterator iterator;
+
+  //! maximum number of variables in one chunk
+  static const size_t maxChunkSize=32;
+
+  PState();
+  PState(const PState& other);
+  PState& operator=(const PState& other);
   friend ostream& operator<<(ostream& os, const PState& value);
   friend istream& operator>>(istream& os, PState& value);
   bool varExists(VariableId varId) const;
@@ -62,6 +140,31 @@ class PState : public map<VariableId,CodeThorn::CppCapsuleAValue> {
   void setVariableToTop(VariableId varId);
   void setVariableToValue(VariableId varId, CodeThorn::CppCapsuleAValue val);
   VariableIdSet getVariableIds() const;
+
+  // map interface
+  const_iterator begin() const { return const_iterator(&_chunks,0,0); }
+  const_iterator end() const { return const_iterator(&_chunks,_chunks.size(),0); }
+  const_iterator find(VariableId varId) const;
+  size_t count(VariableId varId) const { return find(varId)!=end(); }
+  size_t size() const { return _size; }
+  bool empty() const { return _size==0; }
+  //! inserts the variable with a default (bot) value if it does not exist
+  CodeThorn::CppCapsuleAValue& operator[](VariableId varId);
+  size_t erase(VariableId varId);
+  void clear();
+
+  //! hash value of the elements; independent of how they are distributed over chunks
+  long hash() const;
+  bool operator==(const PState& other) const;
+  bool operator!=(const PState& other) const { return !(*this==other); }
+ private:
+  size_t chunkNr(VariableId varId) const;
+  Chunk& modifiableChunk(size_t nr);
+  void rehash() const;
+  vector<ChunkPtr> _chunks;
+  size_t _size;
+  mutable long _hash;
+  mutable bool _hashIsValid;
 };
 
   ostream& operator<<(ostream& os, const PState& value);
@@ -74,11 +177,7 @@ class PStateHashFun {
    public:
     PStateHashFun(long prime=9999991) : tabSize(prime) {}
     long operator()(PState s) const {
-      unsigned int hash=1;
-      for(PState::iterator i=s.begin();i!=s.end();++i) {
-        hash=((hash<<8)+((long)(*i).second.getValue().hash()))^hash;
-      }
-      return long(hash) % tabSize;
+      return long((unsigned long)s.hash() % tabSize);
     }
       long tableSize() const { return tabSize;}
    private:
@@ -89,11 +188,7 @@ class PStateHashFun {
    public:
     PStateHashFun() {}
     long operator()(PState* s) const {
-      unsigned int hash=1;
-      for(PState::iterator i=s->begin();i!=s->end();++i) {
-        hash=((hash<<8)+((long)(*i).second.getValue().hash()))^hash;
-      }
-      return long(hash);
+      return s->hash();
     }
    private:
 };
@@ -102,15 +197,7 @@ class PStateEqualToPred {
    public:
     PStateEqualToPred() {}
     bool operator()(PState* s1, PState* s2) const {
-      if(s1->size()!=s2->size()) {
-        return false;
-      } else {
-        for(PState::iterator i1=s1->begin(), i2=s2->begin();i1!=s1->end();(++i1,++i2)) {
-          if(*i1!=*i2)
-            return false;
-        }
-      }
-      return true;
+      return *s1==*s2;
     }
    private:
 };
@@ -192,6 +279,8 @@ class EState {
   bool isConst(VariableIdMapping* vid) const;
   bool isRersTopified(VariableIdMapping* vid) const;
   string predicateToString(VariableIdMapping* vid) const;
+  static void* operator new(size_t size) { return SpillArena::allocate(size); }
+  static void operator delete(void* p, size_t size) { SpillArena::deallocate(p,size); }
  private:
   Label _label;
   const PState* _pstate;
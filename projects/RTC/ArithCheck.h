@@ -14,6 +14,7 @@ typedef std::map<const SgVariableSymbol *, SgVariableSymbol *> VariableSymbolMap
 typedef std::map<SgSymbol *, SgSymbol *> SymbolMap_t;
 typedef Rose_STL_Container<SgName> SgNameList;
 typedef std::map<std::string, SgClassDeclaration*> StringClassMap_t;
+typedef std::map<std::string, std::string> StringMap_t;
 typedef std::map<std::string, SgVariableDeclaration*> NameVarMap_t;
 typedef Rose_STL_Container<SgType*> SgTypeList;
 typedef std::map<SgExpression*, SgExpression*> ExprMap_t;
@@ -151,6 +152,8 @@ class ArithCheck {
 	static FuncInfoList ForwardDecls;
 	static uint64_t TravCtr;
 	static StringClassMap_t TransClassDecls; 
+	// maps the name of each generated overload to its op (Deref, Add, ...)
+	static StringMap_t OverloadOps;
 
 	void registerCheck();
 
@@ -178,6 +181,11 @@ class ArithCheck {
 	void HackyPtrCheck7();
 	void InstrumentNodes4(SgProject*);
 
+	void eliminateRedundantChecks(SgProject*);
+	void eliminateRedundantChecks(SgBasicBlock*);
+	bool isCheckPreservingCall(SgFunctionCallExp*);
+	SgVarRefExp* getCheckedVarForDeref(SgFunctionCallExp*);
+
 	SgStatement* getSuitablePrevStmt(SgStatement*);
 	
 	void handleVarDecls4(SgVariableDeclaration* var_decl);
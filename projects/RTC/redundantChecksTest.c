@@ -0,0 +1,20 @@
+/* Input for the redundant check elimination test. The second and the
+ * fourth dereference of p are checked by the statement before them,
+ * so only two of the four Deref calls on p are left after RTC. */
+#include <stdlib.h>
+
+int main() {
+  int *p = (int*)malloc(4*sizeof(int));
+  int sum = 0;
+
+  p[0] = 1;
+  p[1] = 2;
+  sum = sum + *p;
+  sum = sum + *p;
+  p = p + 1;
+  sum = sum + *p;
+  sum = sum + *p;
+  free(p - 1);
+
+  return sum == 6 ? 0 : 1;
+}
@@ -397,7 +397,7 @@ void RuntimeSystem::createObject(Address address, const RsClassType* type)
         {
           // Same address, larger size.  We assume that a base type was
           // registered, and now the derived's constructor has been called
-          mt->resize( szObj );
+          memManager.resizeMemory( *mt, szObj );
 
           // \note address == mt->beginAddress(), thus ofs of forceRegisterType is always 0
           mt->forceRegisterMemType( type );
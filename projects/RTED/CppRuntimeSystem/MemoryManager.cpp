@@ -196,31 +196,13 @@ bool MemoryType::operator< (const MemoryType& other) const
 bool MemoryType::isInitialized(Location addr, size_t len) const
 {
     const size_t           offset = byte_offset(startAddress, addr, blockSize(), 0);
-    const size_t           limit = offset + len;
 
-    for (size_t i = offset; i < limit; ++i)
-    {
-        if ( !byteInitialized(i) ) return false;
-    }
-
-    return true;
+    return initdata.allSet(offset, len);
 }
 
 bool MemoryType::initialize(size_t offset, size_t len)
 {
-    const size_t limit = offset + len;
-    bool         statuschange = false;
-
-    for (size_t i = offset; i < limit; ++i)
-    {
-      if (!initdata[i])
-      {
-        statuschange = true;
-        initdata[i] = true;
-      }
-    }
-
-    return statuschange;
+    return initdata.set(offset, len);
 }
 
 static inline
@@ -562,25 +544,8 @@ MemoryType::InitStatus initializationStatus(const MemoryType::InitData& initdata
 {
   assert(initdata.size() > 0);
 
-  bool         allset   = true;
-  bool         allunset = true;
-  const size_t last = initdata.size();
-  size_t       i = 0;
-
-  while (i < last && (allset || allunset))
-  {
-    const bool isset = initdata[i];
-
-    allset   = allset && isset;
-    allunset = allunset && !isset;
-
-    ++i;
-  }
-
-  assert(!(allset && allunset));
-
-  if (allset)   return MemoryType::all;
-  if (allunset) return MemoryType::none;
+  if (initdata.allSet(0, initdata.size()))  return MemoryType::all;
+  if (initdata.noneSet(0, initdata.size())) return MemoryType::none;
   return MemoryType::some;
 }
 
@@ -700,7 +665,11 @@ MemoryType* MemoryManager::findContainingMem(Location addr, size_t size)
 
     if (!res)
     {
-      res = ::validateMembership(findPossibleMemMatch(addr), addr, size);
+      res = shadow.find(addr, size);
+
+      // only distributed allocations are not in the shadow memory
+      if (!res && distributedAllocs)
+        res = ::validateMembership(findPossibleMemMatch(addr), addr, size);
 
       if (res) memtypecache.store(*res);
     }
@@ -711,7 +680,12 @@ MemoryType* MemoryManager::findContainingMem(Location addr, size_t size)
 const MemoryType*
 MemoryManager::findContainingMem(Location addr, size_t size) const
 {
-    return ::validateMembership(findPossibleMemMatch(addr), addr, size);
+    const MemoryType* res = shadow.find(addr, size);
+
+    if (!res && distributedAllocs)
+      res = ::validateMembership(findPossibleMemMatch(addr), addr, size);
+
+    return res;
 }
 
 bool MemoryManager::existOverlappingMem(Location addr, size_t size, long blocksize) const
@@ -747,6 +721,11 @@ MemoryType* MemoryManager::allocateMemory(Location adrObj, size_t szObj, MemoryT
     MemoryTypeSet::value_type v(adrObj, tmp);
     MemoryType&               res = mem.insert(v).first->second;
 
+    if (res.isDistributed())
+      ++distributedAllocs;
+    else
+      shadow.insert(res);
+
     memtypecache.store(res);
     return &res;
 }
@@ -883,7 +862,12 @@ void MemoryManager::freeMemory(MemoryType* m, MemoryType::AllocKind freekind)
     // remove entry from cache
     memtypecache.clear(*m);
 
-    // successful free, erase allocation info from map
+    // successful free, erase allocation info from the shadow memory and map
+    if (m->isDistributed())
+      --distributedAllocs;
+    else
+      shadow.erase(*m);
+
     mem.erase(m->beginAddress());
 
     if ( diagnostics::message(diagnostics::memory) )
@@ -913,6 +897,16 @@ void MemoryManager::freeStackMemory(Location addr)
     freeMemory( mt, mt->howCreated() );
 }
 
+void MemoryManager::resizeMemory(MemoryType& mt, size_t size)
+{
+    // the shadow memory indexes the pages covered by an allocation
+    if (!mt.isDistributed()) shadow.erase(mt);
+
+    mt.resize(size);
+
+    if (!mt.isDistributed()) shadow.insert(mt);
+}
+
 template <class MemManager>
 static
 typename ConstLike<MemManager, MemoryType>::type*
@@ -1291,6 +1285,8 @@ const MemoryType* MemoryManager::getMemoryType(Location addr) const
 
 void MemoryManager::clearStatus()
 {
+  shadow.clear();
+  distributedAllocs = 0;
   mem.clear();
   memtypecache.clear();
 }
@@ -16,6 +16,7 @@
 
 #include "ptrops.h"
 #include "ptrops_operators.h"
+#include "ShadowMemory.h"
 
 
 class RuntimeSystem;
@@ -36,7 +37,7 @@ struct MemoryType
         typedef rted_AllocKind                  AllocKind;
 
         typedef const char*                     LocalPtr;
-        typedef std::vector<bool>               InitData;
+        typedef InitBits                        InitData;
         typedef std::map<size_t, const RsType*> TypeData;
         typedef TypeData::iterator              TiIter;
 
@@ -200,7 +201,7 @@ struct MemoryManager
         typedef std::map<Location, MemoryType> MemoryTypeSet;
 
         MemoryManager()
-        : mem()
+        : mem(), shadow(), distributedAllocs(0)
         {}
 
         /// \brief  Create a new allocation based on the parameters
@@ -213,6 +214,10 @@ struct MemoryManager
         /// tracks deallocations related to scope exits
         void freeStackMemory(Location addr);
 
+        /// \brief grows an allocation (e.g., when a derived class' constructor
+        ///        is called on the memory of a base class object)
+        void resizeMemory(MemoryType& mt, size_t size);
+
         /// Prints information about all currently allocated memory areas
         void print(std::ostream & os) const;
 
@@ -303,6 +308,13 @@ struct MemoryManager
 
         MemoryTypeSet mem;
 
+        /// page index of the non distributed allocations in mem
+        ShadowMemory  shadow;
+
+        /// number of allocations in mem that are distributed over UPC threads
+        ///   (only those are searched in mem by findContainingMem)
+        size_t        distributedAllocs;
+
         friend class CStdLibManager;
 };
 
@@ -77,25 +77,6 @@ void zeroIntValueAt(Address addr)
   rted_setIntVal(addr, 0);
 }
 
-static
-void insert(PointerManager::TargetToPointerMap& m, const PointerManager::TargetToPointerMap::value_type& val)
-{
-  Address loc = val.first;
-
-  // note, the following assert does not hold, as it can store pointers
-  //   where the targetAddress is set to 0, if the pointer points to nowhere
-  //   (e.g., one past the last element)
-  //   was: assert(val.first == val.second->getTargetAddress())
-  if (loc != val.second->getTargetAddress())
-  {
-    RuntimeSystem::instance().printMessage("#WARNING: corrected pointer target");
-
-    loc = val.second->getTargetAddress();
-  }
-
-  m.insert( PointerManager::TargetToPointerMap::value_type(loc, val.second) );
-}
-
 struct LeakReporter
 {
   const PointerManager&    pm;
@@ -260,7 +241,7 @@ PointerManager::createDereferentiableMem(Location sourceAddress, const RsType& t
         return res.first;
     }
 
-    insert(targetToPointerMap, TargetToPointerMap::value_type(nullAddr(), pi)) /* insert */;
+    insertIntoRevMap(nullAddr(), pi);
     return res.first;
 }
 
@@ -277,41 +258,28 @@ void PointerManager::createTransientPointer(Location points_to, const RsType& t)
     Location          loc = rted_Addr(&transientPtr.second);
 
     transientPtr.first = PointerInfo(loc, points_to, t);
-    insert(targetToPointerMap, TargetToPointerMap::value_type(points_to, &transientPtr.first));
+    insertIntoRevMap(points_to, &transientPtr.first);
 }
 
-struct MemRefDecrementer
+void PointerManager::clearTransientPtr()
 {
-  typedef PointerManager::TargetToPointerMap TargetToPointerMap;
-  typedef PointerManager::TransientPointer   TransientPointer;
-
-  TargetToPointerMap& mapTargetPtr;
-
-  explicit
-  MemRefDecrementer(TargetToPointerMap& mapTargPtr)
-  : mapTargetPtr(mapTargPtr)
-  {}
-
-  void operator()(const TransientPointer& tp)
-  {
-    // if the memory does not exist anymore, then there is nothing to do
-    if (tp.first.getTargetAddress() == nullAddr()) return;
-
-    TargetToPointerMap::iterator zz = mapTargetPtr.end();
-    TargetToPointerMap::iterator cand = mapTargetPtr.lower_bound(tp.second);
+    assert(transientPointers.size() <= 1);
 
-    while ((cand != zz) && (cand->second != &tp.first)) ++cand;
+    for (TransientPointerList::iterator it = transientPointers.begin(); it != transientPointers.end(); ++it)
+    {
+        // if the memory does not exist anymore, then there is nothing to do
+        if (it->first.getTargetAddress() == nullAddr()) continue;
 
-    assert(cand != zz);
-    mapTargetPtr.erase(cand);
-  }
-};
+        const bool res = removeFromRevMap(&it->first);
 
+        assert(res);
+        ez::unused(res);
+    }
 
-void PointerManager::clearTransientPtr()
-{
-    assert(transientPointers.size() <= 1);
-    std::for_each(transientPointers.begin(), transientPointers.end(), MemRefDecrementer(targetToPointerMap));
+    for (TransientPointerList::iterator it = transientPointers.begin(); it != transientPointers.end(); ++it)
+    {
+        revMapIndex.erase(&it->first);
+    }
 
     transientPointers.clear();
 }
@@ -367,6 +335,7 @@ void PointerManager::deletePointer(Location src, bool checkleak)
 
     // Delete from set
     pointerInfoSet.erase(i);
+    revMapIndex.erase(pi);
 
     if (checkleak)
     {
@@ -501,7 +470,7 @@ void PointerManager::registerPointerChange(Location src, Location target, const
             // reads or writes without first registering a pointer change will
             // be treated as invalid
             pi.setTargetAddressForce( nullAddr() );
-            insert(targetToPointerMap, TargetToPointerMap::value_type( nullAddr(), &pi )) /* insert */;
+            insertIntoRevMap(nullAddr(), &pi);
 
             // \pp this is a bug, as RTED changes data of a running program
             if ( !(rs.testing()) ) zeroIntValueAt(pi.getSourceAddress());
@@ -519,11 +488,11 @@ void PointerManager::registerPointerChange(Location src, Location target, const
         } catch(RuntimeViolation & vio) {
             // if target could not been set, then set pointer to null
             pi.setTargetAddressForce( nullAddr() );
-            insert(targetToPointerMap, TargetToPointerMap::value_type(nullAddr(), &pi)) /* insert */;
+            insertIntoRevMap(nullAddr(), &pi);
             throw vio;
         }
         // ...and insert it again with changed target
-        insert(targetToPointerMap, TargetToPointerMap::value_type(target, &pi)) /* insert */;
+        insertIntoRevMap(target, &pi);
     }
 
     checkForMemoryLeaks( oldTarget, pi );
@@ -567,8 +536,8 @@ void PointerManager::invalidatePointerToRegion(const MemoryType& mt)
 
       TargetToPointerMap::iterator toErase = range.iter();
       range.next(); //Once we erase the iterator it's invalid and we can't call next()
-      targetToPointerMap.erase( toErase );
-      insert(targetToPointerMap, TargetToPointerMap::value_type(nullLoc, pi)) /* insert */;
+      eraseFromRevMap( toErase );
+      insertIntoRevMap(nullLoc, pi);
     }
 }
 
@@ -579,6 +548,20 @@ bool PointerManager::removeFromRevMap(PointerInfo* pi)
 
     assert(!targetToPointerMap.empty());
 
+    // the position index holds the last entry that was inserted for pi
+    RevMapIndex::iterator known = revMapIndex.find(pi);
+
+    if (  known != revMapIndex.end()
+       && known->second != targetToPointerMap.end()
+       && known->second->first == pi->getTargetAddress()
+       )
+    {
+        eraseFromRevMap(known->second);
+        return true;
+    }
+
+    // pi has more than one entry (see registerPointerChange)
+    //   or its target changed without updating the map
     std::pair<MapIter,MapIter> range = targetToPointerMap.equal_range(pi->getTargetAddress());
 
     // \note no need to filter, all entries point to a specific target
@@ -586,7 +569,7 @@ bool PointerManager::removeFromRevMap(PointerInfo* pi)
     {
         if( i->second == pi)
         {
-            targetToPointerMap.erase(i);
+            eraseFromRevMap(i);
             return true;
         }
     }
@@ -594,6 +577,33 @@ bool PointerManager::removeFromRevMap(PointerInfo* pi)
     return false;
 }
 
+void PointerManager::insertIntoRevMap(Location loc, PointerInfo* pi)
+{
+  // note, the following assert does not hold, as it can store pointers
+  //   where the targetAddress is set to 0, if the pointer points to nowhere
+  //   (e.g., one past the last element)
+  //   was: assert(loc == pi->getTargetAddress())
+  if (loc != pi->getTargetAddress())
+  {
+    RuntimeSystem::instance().printMessage("#WARNING: corrected pointer target");
+
+    loc = pi->getTargetAddress();
+  }
+
+  revMapIndex[pi] = targetToPointerMap.insert( TargetToPointerMap::value_type(loc, pi) );
+}
+
+void PointerManager::eraseFromRevMap(TargetToPointerMap::iterator pos)
+{
+  RevMapIndex::iterator known = revMapIndex.find(pos->second);
+
+  // the index entry is kept, since the pointer is usually re-inserted
+  //   right away (see registerPointerChange).
+  if (known != revMapIndex.end() && known->second == pos) known->second = targetToPointerMap.end();
+
+  targetToPointerMap.erase(pos);
+}
+
 
 PointerManager::PointerSetIter
 PointerManager::sourceRegionIter(Location sourceAddr) const
@@ -612,6 +622,7 @@ void PointerManager::clearStatus()
 
     pointerInfoSet.clear();
     targetToPointerMap.clear();
+    revMapIndex.clear();
 }
 
 
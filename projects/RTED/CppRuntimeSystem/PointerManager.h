@@ -7,6 +7,8 @@
 #include <list>
 #include <iosfwd>
 
+#include <boost/unordered_map.hpp>
+
 #include "Util.h"
 #include "TypeSystem.h"
 
@@ -115,6 +117,9 @@ struct PointerManager
         typedef PointerSet::const_iterator               PointerSetIter;
         typedef std::multimap<Location, PointerInfo*>    TargetToPointerMap;
 
+        /// position of a pointer's entry in the TargetToPointerMap
+        typedef boost::unordered_map<const PointerInfo*, TargetToPointerMap::iterator> RevMapIndex;
+
         // \todo check if PointerInfo is sufficient ...
         typedef std::pair<PointerInfo, Address>          TransientPointer;
 
@@ -265,6 +270,12 @@ struct PointerManager
         /// @return false if not found in map
         bool removeFromRevMap(PointerInfo * p);
 
+        /// Adds a PointerInfo to targetToPointerMap
+        void insertIntoRevMap(Location target, PointerInfo* p);
+
+        /// Erases an entry from targetToPointerMap
+        void eraseFromRevMap(TargetToPointerMap::iterator pos);
+
 #if OBSOLETE_CODE
         /// Checks to see if pointer_being_removed was the last pointer pointing
         /// to some memory chunk.
@@ -287,6 +298,9 @@ struct PointerManager
 
         TargetToPointerMap        targetToPointerMap;  ///< Map to get all pointer which point to a specific target address
                                                        ///  maps targetAddress -> Set of PointerInfos
+        RevMapIndex               revMapIndex;         ///< finds the entry of a pointer in targetToPointerMap
+                                                       ///  without scanning all pointers with the same target
+                                                       ///  (most pointers point to NULL)
 
         TransientPointerList      transientPointers;
 };
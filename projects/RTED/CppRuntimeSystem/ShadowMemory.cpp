@@ -0,0 +1,237 @@
+// vim:et sta sw=4 ts=4
+#include <algorithm>
+#include <cassert>
+
+#include "ShadowMemory.h"
+#include "MemoryManager.h"
+
+// -----------------------    InitBits  --------------------------------------
+
+const size_t InitBits::WORDBITS;
+
+/// \brief mask of the bits [from, to) in a word (0 <= from < to <= WORDBITS)
+static inline
+InitBits::Word rangeMask(size_t from, size_t to)
+{
+  const InitBits::Word all = ~InitBits::Word(0);
+  const InitBits::Word upper = (to == InitBits::WORDBITS) ? all : ((InitBits::Word(1) << to) - 1);
+
+  return upper & (all << from);
+}
+
+void InitBits::resize(size_t n)
+{
+  // clear the unused bits of the last word, so they are not set when the size grows
+  if (nbits % WORDBITS) words.back() &= rangeMask(0, nbits % WORDBITS);
+
+  nbits = n;
+  words.resize((n + WORDBITS - 1) / WORDBITS, 0);
+}
+
+bool InitBits::allSet(size_t ofs, size_t len) const
+{
+  assert(ofs + len <= nbits);
+
+  size_t       i = ofs;
+  const size_t limit = ofs + len;
+
+  while (i < limit)
+  {
+    const size_t w = i / WORDBITS;
+    const size_t to = std::min(limit - w * WORDBITS, WORDBITS);
+    const Word   mask = rangeMask(i % WORDBITS, to);
+
+    if ((words[w] & mask) != mask) return false;
+
+    i = (w + 1) * WORDBITS;
+  }
+
+  return true;
+}
+
+bool InitBits::noneSet(size_t ofs, size_t len) const
+{
+  assert(ofs + len <= nbits);
+
+  size_t       i = ofs;
+  const size_t limit = ofs + len;
+
+  while (i < limit)
+  {
+    const size_t w = i / WORDBITS;
+    const size_t to = std::min(limit - w * WORDBITS, WORDBITS);
+
+    if (words[w] & rangeMask(i % WORDBITS, to)) return false;
+
+    i = (w + 1) * WORDBITS;
+  }
+
+  return true;
+}
+
+bool InitBits::set(size_t ofs, size_t len)
+{
+  assert(ofs + len <= nbits);
+
+  size_t       i = ofs;
+  const size_t limit = ofs + len;
+  bool         statuschange = false;
+
+  while (i < limit)
+  {
+    const size_t w = i / WORDBITS;
+    const size_t to = std::min(limit - w * WORDBITS, WORDBITS);
+    const Word   mask = rangeMask(i % WORDBITS, to);
+
+    statuschange = statuschange || ((words[w] & mask) != mask);
+    words[w] |= mask;
+
+    i = (w + 1) * WORDBITS;
+  }
+
+  return statuschange;
+}
+
+
+// -----------------------    ShadowMemory  --------------------------------------
+
+const size_t ShadowMemory::PAGEBITS;
+const size_t ShadowMemory::REGIONBITS;
+
+ShadowMemory::RegionKey
+ShadowMemory::regionKey(Location addr, size_t& pagenum)
+{
+  const size_t page = reinterpret_cast<size_t>(addr.local) >> PAGEBITS;
+  RegionKey    key;
+
+  key.number = page >> REGIONBITS;
+#ifdef WITH_UPC
+  key.thread = addr.thread_id;
+#endif /* WITH_UPC */
+
+  pagenum = page & ((size_t(1) << REGIONBITS) - 1);
+  return key;
+}
+
+ShadowMemory::Region* ShadowMemory::findRegion(const RegionKey& key) const
+{
+  if (lastRegion && lastKey == key) return lastRegion;
+
+  RegionMap::const_iterator pos = regions.find(key);
+
+  if (pos == regions.end()) return NULL;
+
+  lastKey = key;
+  lastRegion = pos->second;
+  return lastRegion;
+}
+
+template <class Op>
+void ShadowMemory::forEachPage(const MemoryType& mt, bool create, Op op)
+{
+  assert(!mt.isDistributed());
+
+  if (mt.getSize() == 0) return;
+
+  Location     first = mt.beginAddress();
+  Location     last = mt.lastValidAddress();
+  const size_t firstpage = reinterpret_cast<size_t>(first.local) >> PAGEBITS;
+  const size_t lastpage = reinterpret_cast<size_t>(last.local) >> PAGEBITS;
+
+  for (size_t page = firstpage; page <= lastpage; ++page)
+  {
+    Location addr = first;
+    size_t   pagenum = 0;
+
+    addr.local = reinterpret_cast<const char*>(page << PAGEBITS);
+
+    const RegionKey key = regionKey(addr, pagenum);
+    Region*         region = findRegion(key);
+
+    if (!region)
+    {
+      assert(create);
+      region = new Region;
+      regions[key] = region;
+    }
+
+    region->used += op(region->pages[pagenum]);
+
+    if (region->used == 0)
+    {
+      regions.erase(key);
+      if (lastRegion == region) lastRegion = NULL;
+      delete region;
+    }
+  }
+}
+
+namespace
+{
+  struct PageInserter
+  {
+    MemoryType* mt;
+
+    explicit PageInserter(MemoryType& m) : mt(&m) {}
+
+    long operator()(std::vector<MemoryType*>& page) const
+    {
+      page.push_back(mt);
+      return 1;
+    }
+  };
+
+  struct PageEraser
+  {
+    const MemoryType* mt;
+
+    explicit PageEraser(const MemoryType& m) : mt(&m) {}
+
+    long operator()(std::vector<MemoryType*>& page) const
+    {
+      std::vector<MemoryType*>::iterator pos = std::find(page.begin(), page.end(), mt);
+
+      assert(pos != page.end());
+      page.erase(pos);
+      return -1;
+    }
+  };
+}
+
+void ShadowMemory::insert(MemoryType& mt)
+{
+  forEachPage(mt, true, PageInserter(mt));
+}
+
+void ShadowMemory::erase(const MemoryType& mt)
+{
+  forEachPage(mt, false, PageEraser(mt));
+}
+
+MemoryType* ShadowMemory::find(Location addr, size_t size) const
+{
+  size_t        pagenum = 0;
+  const Region* region = findRegion(regionKey(addr, pagenum));
+
+  if (!region) return NULL;
+
+  const Page& page = region->pages[pagenum];
+
+  for (Page::const_iterator it = page.begin(); it != page.end(); ++it)
+  {
+    if ((*it)->containsMemArea(addr, size)) return *it;
+  }
+
+  return NULL;
+}
+
+void ShadowMemory::clear()
+{
+  for (RegionMap::iterator it = regions.begin(); it != regions.end(); ++it)
+  {
+    delete it->second;
+  }
+
+  regions.clear();
+  lastRegion = NULL;
+}
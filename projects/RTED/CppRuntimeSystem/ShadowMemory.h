@@ -0,0 +1,167 @@
+// vim:et sta sw=4 ts=4
+#ifndef SHADOWMEMORY_H
+#define SHADOWMEMORY_H
+
+#include <vector>
+#include <cstddef>
+#include <boost/unordered_map.hpp>
+
+#include "ptrops.h"
+#include "ptrops_operators.h"
+#include "rted_typedefs.h"
+
+struct MemoryType;
+
+/**
+ * \brief Initialization status of an allocation, one bit per byte.
+ *
+ * Ranges of bits are tested and set a machine word at a time, so checking
+ * that an access of n bytes reads initialized memory costs O(n/64) instead
+ * of O(n).
+ */
+struct InitBits
+{
+        typedef unsigned long Word;
+
+        static const size_t WORDBITS = sizeof(Word) * 8;
+
+        explicit
+        InitBits(size_t n = 0)
+        : nbits(n), words((n + WORDBITS - 1) / WORDBITS, 0)
+        {}
+
+        size_t size() const { return nbits; }
+
+        bool operator[](size_t i) const
+        {
+          return (words[i / WORDBITS] >> (i % WORDBITS)) & 1;
+        }
+
+        /// Changes the number of bits; new bits are not set
+        void resize(size_t n);
+
+        /// Tests whether all bits in [ofs, ofs+len) are set
+        bool allSet(size_t ofs, size_t len) const;
+
+        /// Tests whether no bit in [ofs, ofs+len) is set
+        bool noneSet(size_t ofs, size_t len) const;
+
+        /// Sets all bits in [ofs, ofs+len)
+        /// \return true, iff at least one bit was not set before
+        bool set(size_t ofs, size_t len);
+
+    private:
+        size_t            nbits;
+        std::vector<Word> words;
+};
+
+
+/// \brief hash function for addresses (used by boost::unordered containers)
+/// \note  consistent with operator==, which ignores the thread of null pointers
+inline
+size_t hash_value(const Address& addr)
+{
+  size_t res = reinterpret_cast<size_t>(addr.local);
+
+#ifdef WITH_UPC
+  if (addr.local) res ^= size_t(addr.thread_id) << 1;
+#endif /* WITH_UPC */
+
+  return res ^ (res >> 17);
+}
+
+
+/**
+ * \class ShadowMemory
+ * \brief Maps addresses to the allocations that contain them.
+ *
+ * The address space is divided into pages of 2^PAGEBITS bytes, and groups
+ * of 2^REGIONBITS pages form a region. Each page of a region lists the
+ * allocations that overlap the page, so finding the allocation of an
+ * address is a hash lookup of the region, a direct index into the pages of
+ * the region, and a scan of the (few) allocations in the page. The last
+ * region that was looked up is cached, because consecutive accesses tend
+ * to fall into the same region.
+ *
+ * Allocations that are distributed over UPC threads (blocksize != 0) are
+ * not contiguous in any address space, and are not stored here.
+ */
+struct ShadowMemory
+{
+        typedef Address Location;
+
+        static const size_t PAGEBITS = 12;
+        static const size_t REGIONBITS = 10;
+
+        ShadowMemory()
+        : regions(), lastKey(), lastRegion(NULL)
+        {}
+
+        ~ShadowMemory() { clear(); }
+
+        /// Registers a non distributed allocation
+        void insert(MemoryType& mt);
+
+        /// Removes a registered allocation
+        void erase(const MemoryType& mt);
+
+        /// Returns the allocation that contains [addr, addr+size), or NULL
+        MemoryType* find(Location addr, size_t size) const;
+
+        /// Removes all allocations
+        void clear();
+
+        /// Number of regions (for statistics)
+        size_t regionCount() const { return regions.size(); }
+
+    private:
+        /// allocations overlapping one page
+        typedef std::vector<MemoryType*> Page;
+
+        struct Region
+        {
+          Page   pages[size_t(1) << REGIONBITS];
+          size_t used;   ///< number of (allocation, page) entries
+
+          Region() : used(0) {}
+        };
+
+        /// region number; in UPC a region belongs to one thread
+        struct RegionKey
+        {
+          size_t         number;
+          rted_thread_id thread;
+
+          RegionKey() : number(0), thread(0) {}
+
+          bool operator==(const RegionKey& other) const
+          {
+            return number == other.number && thread == other.thread;
+          }
+        };
+
+        friend size_t hash_value(const RegionKey& key)
+        {
+          return key.number ^ (size_t(key.thread) << 20);
+        }
+
+        typedef boost::unordered_map<RegionKey, Region*> RegionMap;
+
+        static RegionKey regionKey(Location addr, size_t& pagenum);
+
+        Region* findRegion(const RegionKey& key) const;
+
+        /// calls op(page) for all pages overlapped by mt
+        template <class Op>
+        void forEachPage(const MemoryType& mt, bool create, Op op);
+
+        RegionMap         regions;
+        mutable RegionKey lastKey;
+        mutable Region*   lastRegion;
+
+        // not copyable
+        ShadowMemory(const ShadowMemory&);
+        ShadowMemory& operator=(const ShadowMemory&);
+};
+
+#endif
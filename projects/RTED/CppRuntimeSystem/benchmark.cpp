@@ -0,0 +1,161 @@
+// vim:sw=4 ts=4 tw=80 et sta fdm=marker:
+//
+// Measures the overhead of the runtime checks (allocation lookup,
+//   initialization bits, pointer bookkeeping) that instrumented
+//   RTED programs call for every access.
+//
+// usage: RuntimeSystemCppBenchmark [number of allocations]
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <ctime>
+
+#include "CppRuntimeSystem.h"
+#include "rtedsync.h"
+
+using namespace std;
+
+static const long   nondistributed = 0;
+static const size_t allocsize = 48;
+static const size_t rounds = 20;
+
+inline
+Address asAddr(size_t sysaddr)
+{
+  return rted_Addr(reinterpret_cast<char*>(sysaddr));
+}
+
+/// simulated address of the i-th allocation (allocations are not adjacent)
+static inline
+Address allocAddr(size_t i, size_t ofs = 0)
+{
+  return asAddr(0x10000 + i * (allocsize + 16) + ofs);
+}
+
+/// simulated address of the i-th pointer
+static inline
+Address pointerAddr(size_t base, size_t i)
+{
+  return asAddr(base + i * sizeof(void*));
+}
+
+static
+void report(const char* what, clock_t start, size_t ops)
+{
+  const double secs = double(clock() - start) / CLOCKS_PER_SEC;
+
+  cout << "  " << setw(24) << left << what
+       << setw(10) << right << ops << " ops "
+       << setw(10) << fixed << setprecision(1) << (secs * 1e9 / ops) << " ns/op"
+       << endl;
+}
+
+static
+void benchmark(size_t numallocs)
+{
+  RuntimeSystem&       rs = RuntimeSystem::instance();
+  TypeSystem&          ts = rs.getTypeSystem();
+  const RsPointerType& intptr = *ts.getPointerType("SgTypeInt");
+  const size_t         ptrbase = 0x10000 + (numallocs + 1) * (allocsize + 16);
+
+  const SourceInfo     pos = { "benchmark", __LINE__, __LINE__ };
+
+  rs.checkpoint(pos);
+
+  // the benchmark moves pointers between allocations, which leaves
+  //   allocations without pointers.
+  rs.setViolationPolicy( RuntimeViolation::MEM_WITHOUT_POINTER, ViolationPolicy::Ignore );
+
+  cout << "-- " << numallocs << " allocations of " << allocsize << " bytes" << endl;
+
+  clock_t start = clock();
+
+  for (size_t i = 0; i < numallocs; ++i)
+    rs.createMemory(allocAddr(i), allocsize, akCxxNew, nondistributed, NULL);
+
+  report("createMemory", start, numallocs);
+
+  start = clock();
+  for (size_t r = 0; r < rounds; ++r)
+    for (size_t i = 0; i < numallocs; ++i)
+      rs.checkMemWrite(allocAddr(i, (r % (allocsize / sizeof(int))) * sizeof(int)), sizeof(int));
+
+  report("checkMemWrite", start, rounds * numallocs);
+
+  start = clock();
+  for (size_t r = 0; r < rounds; ++r)
+    for (size_t i = 0; i < numallocs; ++i)
+      rs.checkMemRead(allocAddr((i * 7919) % numallocs), sizeof(int));
+
+  report("checkMemRead (random)", start, rounds * numallocs);
+
+  for (size_t i = 0; i < numallocs; ++i)
+    rs.getPointerManager().createPointer(pointerAddr(ptrbase, i), &intptr, nondistributed);
+
+  // pointers are registered in random order, thus the pointer can be
+  //   anywhere among the NULL pointers in the reverse map
+  start = clock();
+  for (size_t i = 0; i < numallocs; ++i)
+  {
+    const size_t p = (i * 7919) % numallocs;
+
+    rs.registerPointerChange(pointerAddr(ptrbase, p), allocAddr(p), intptr, false);
+  }
+
+  report("registerPointerChange", start, numallocs);
+
+  start = clock();
+  for (size_t r = 1; r <= rounds; ++r)
+    for (size_t i = 0; i < numallocs; ++i)
+      rs.registerPointerChange(pointerAddr(ptrbase, i), allocAddr((i + r) % numallocs), intptr, false);
+
+  report("move pointer", start, rounds * numallocs);
+
+  start = clock();
+  for (size_t i = 0; i < numallocs; ++i)
+    rs.freeMemory(allocAddr(i), akCxxNew);
+
+  report("freeMemory", start, numallocs);
+
+  rs.clearStatus();
+  rs.setViolationPolicy( RuntimeViolation::MEM_WITHOUT_POINTER, ViolationPolicy::Exit );
+}
+
+
+extern "C"
+{
+  int upc_main(int noargs, char** args, char**)
+  {
+      const size_t numallocs = (noargs > 1) ? strtoul(args[1], NULL, 10) : 100000;
+
+      rted_UpcAllInitWorkzone();
+      rted_UpcEnterWorkzone();
+
+      try
+      {
+          RuntimeSystem& rs = RuntimeSystem::instance();
+          rs.setTestingMode(true);
+          rs.setOutputFile("benchmark_output.txt");
+
+          benchmark(numallocs / 10);
+          benchmark(numallocs);
+      }
+      catch( RuntimeViolation& e)
+      {
+          cout << "Unexpected Error: " << endl << e;
+          exit( 1);
+      }
+
+      return 0;
+  }
+
+#ifdef WITH_UPC
+  // \hack see comment in CppRuntimeSystem/ptrops.upc
+  char rted_base_hack[0];
+#else
+  int main(int noargs, char** args, char** envp)
+  {
+    return upc_main(noargs, args, envp);
+  }
+#endif /* !WITH_UPC */
+}
@@ -296,6 +296,12 @@ public:
      *  Thread safety:  This method is thread safe. */
     void clear_memory_callbacks(When);
 
+    /** Returns true if any pre- or post-memory callbacks are registered.  The simulator uses this to decide whether it must
+     *  read instruction bytes through the RSIM_Process memory interface, or whether it may use its translation cache.
+     *
+     *  Thread safety:  This method is thread safe. */
+    bool has_memory_callbacks() const;
+
     /** Invokes all the memory callbacks.  The pre- or post-memory callbacks (depending on the value of @p when) are
      *  invoked in the order they were registered.  The specified @p prev value is passed to the first callback as its @p prev
      *  argument; subsequent callbacks' @p prev argument is the return value of the previous callback; the return value of the
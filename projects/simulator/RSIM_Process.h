@@ -14,7 +14,8 @@ public:
     /** Creates an empty process containing no threads. */
     explicit RSIM_Process(RSIM_Simulator *simulator)
         : simulator(simulator), tracing_file(NULL), tracing_flags(0),
-          brk_va(0), mmap_start(0x40000000ul), mmap_recycle(false), disassembler(NULL), futexes(NULL),
+          brk_va(0), mmap_start(0x40000000ul), mmap_recycle(false), disassembler(NULL),
+          xlate_enabled(true), xlate_generation(0), xlate_ntranslated(0), xlate_ninvalidated(0), futexes(NULL),
           interpretation(NULL), ep_orig_va(0), ep_start_va(0),
           terminated(false), termination_status(0), project(NULL), core_flags(0), btrace_file(NULL),
           vdso_mapped_va(0), vdso_entry_va(0),
@@ -440,6 +441,90 @@ public:
 
 
 
+    /**************************************************************************************************************************
+     *                                  Translation cache
+     **************************************************************************************************************************/
+public:
+    /** A pre-decoded basic block.  The instructions are contiguous in specimen memory and only the last one may transfer
+     *  control.  Blocks are immutable once they're in the cache; invalidating a block removes it from the cache but threads
+     *  that are still holding a pointer to it can finish using it. */
+    struct TranslatedBlock {
+        rose_addr_t va;                                 /**< Address of the first instruction. */
+        rose_addr_t end_va;                             /**< One past the last byte of the last instruction. */
+        std::vector<SgAsmX86Instruction*> insns;        /**< Instructions in execution order. Never empty. */
+        explicit TranslatedBlock(rose_addr_t va): va(va), end_va(va) {}
+    };
+    typedef boost::shared_ptr<const TranslatedBlock> TranslatedBlockPtr;
+
+    /** Maximum number of instructions in a translated block. */
+    static const size_t TRANSLATED_BLOCK_MAX_INSNS = 64;
+
+private:
+    typedef std::map<rose_addr_t, TranslatedBlockPtr> TranslatedBlocks;
+    typedef std::map<rose_addr_t, std::set<rose_addr_t> > TranslatedPages;
+
+    bool xlate_enabled;                         /**< Whether get_translated_block() may return blocks. */
+    TranslatedBlocks xlate_blocks;              /**< Translated blocks indexed by starting address. */
+    TranslatedPages xlate_pages;                /**< Starting addresses of the blocks that overlap each page. */
+    size_t xlate_generation;                    /**< Incremented whenever a block is invalidated. */
+    size_t xlate_ntranslated;                   /**< Number of blocks translated so far. */
+    size_t xlate_ninvalidated;                  /**< Number of blocks invalidated so far. */
+
+    /* Removes all translated blocks that overlap the specified address range.  The caller must hold the write lock. */
+    void translation_invalidate(rose_addr_t va, size_t nbytes);
+
+public:
+    /** Returns the translated block that starts at the specified address, translating it if necessary.
+     *
+     *  A translated block is a run of instructions starting at @p va and ending at the first control transfer instruction, an
+     *  instruction that cannot be disassembled, or TRANSLATED_BLOCK_MAX_INSNS, whichever comes first.  The instructions are
+     *  obtained with get_instruction() so they are shared with the process' instruction cache.  Threads can step through a
+     *  block without looking up, re-reading or re-decoding each instruction, which is where the simulator used to spend much
+     *  of its time.
+     *
+     *  Blocks are invalidated whenever memory they overlap is written through mem_write() or my_addr(), or remapped by
+     *  mem_map(), mem_unmap(), mem_protect(), mem_setbrk() or a memory transaction.  Code that modifies specimen memory some
+     *  other way (e.g., directly through get_memory()) should call flush_translation_cache().  Each invalidation increments
+     *  the translation generation; a thread holding a block should stop using it once the generation has changed.  If the
+     *  @p generation argument is non-null then it is set to the generation at the time the block was looked up.
+     *
+     *  A null pointer is returned if the translation cache is disabled or if any memory callbacks are registered, since such
+     *  callbacks expect to see each instruction fetch. Callers should fall back to get_instruction() in that case.  An
+     *  exception is thrown if the first instruction cannot be disassembled, just like get_instruction().
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    TranslatedBlockPtr get_translated_block(rose_addr_t va, size_t *generation=NULL);
+
+    /** Returns the current translation generation.  See get_translated_block().
+     *
+     *  Thread safety:  This method does not lock; the simulator calls it once per instruction.  Writes to code by one thread
+     *  are seen by that thread immediately, but may be seen a few instructions late by other threads.  The same race exists
+     *  on real hardware without explicit synchronization. */
+    size_t get_translation_generation() const {
+        return xlate_generation;
+    }
+
+    /** Property that determines whether translated blocks are used.  The default is to use them; the --no-translation-cache
+     *  simulator switch turns them off.  Disabling the cache also empties it.
+     *
+     *  Thread safety:  These methods are thread safe; they can be invoked on a single object by multiple threads concurrently.
+     *  @{ */
+    bool get_translation_cache() const;
+    void set_translation_cache(bool b=true);
+    /** @} */
+
+    /** Discards all translated blocks.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    void flush_translation_cache();
+
+    /** Translation cache statistics: number of blocks currently cached, number translated, and number invalidated.
+     *
+     *  Thread safety:  This method is thread safe; it can be invoked on a single object by multiple threads concurrently. */
+    void get_translation_stats(size_t *ncached, size_t *ntranslated, size_t *ninvalidated) const;
+
+
+
     /**************************************************************************************************************************
      *                                  Signal handling
      **************************************************************************************************************************/
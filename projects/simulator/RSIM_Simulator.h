@@ -6,6 +6,8 @@
  * simulator. */
 #include "threadSupport.h"
 
+#include <boost/shared_ptr.hpp>
+
 /* Order matters */
 #include "RSIM_Common.h"
 #include "RSIM_SignalHandling.h"
@@ -185,7 +187,8 @@ public:
      *  initial process. */
     RSIM_Simulator()
         : global_semaphore(NULL),
-          tracing_flags(0), core_flags(CORE_ELF), btrace_file(NULL), active(0), process(NULL), entry_va(0) {
+          tracing_flags(0), core_flags(CORE_ELF), btrace_file(NULL), translation_cache(true), active(0), process(NULL),
+          entry_va(0) {
         ctor();
     }
 
@@ -688,6 +691,7 @@ private:
     std::string interp_name;            /**< Name of command-line specified interpreter for dynamic linking. */
     std::vector<std::string> vdso_paths;/**< Files and/or directories to search for a virtual dynamic shared library. */
     FILE *btrace_file;                  /**< Name for binary trace file, which will log info about process execution. */
+    bool translation_cache;             /**< Whether processes use translated blocks. See RSIM_Process::get_translated_block() */
 
     /* Simulator activation/deactivation */
     unsigned active;                    /**< Levels of activation. See activate(). */
@@ -18,6 +18,7 @@ public:
     RSIM_Thread(RSIM_Process *process)
         : process(process), my_tid(-1),
           mesg_prefix(this), report_interval(10.0), do_coredump(true), show_exceptions(true),
+          xlate_index(0), xlate_generation(0), xlate_nfast(0), xlate_nlookups(0),
           policy(this), semantics(policy),
           robust_list_head_va(0), clear_child_tid(0) {
         real_thread = pthread_self();
@@ -581,9 +582,30 @@ public:
 
     /** Returns instruction at current IP, disassembling it if necessary, and caching it.  Since the simulated memory belongs
      *  to the entire RSIM_Process, all this method does is obtain the thread's current instruction address and then has the
-     *  RSIM_Process disassemble the instruction. */
+     *  RSIM_Process disassemble the instruction.
+     *
+     *  The thread remembers the translated block (see RSIM_Process::get_translated_block()) that it is executing and its
+     *  position in that block.  As long as execution falls through to the next instruction of the block or branches back to
+     *  its start, and the process' translation generation hasn't changed, the instruction is returned without locking,
+     *  reading memory or decoding. */
     SgAsmX86Instruction *current_insn();
 
+    /** Translation cache statistics for this thread: number of instructions returned by current_insn() directly from the
+     *  thread's current block, and number of times a block had to be looked up in the process. */
+    void get_translation_stats(size_t *nfast, size_t *nlookups) const {
+        if (nfast)
+            *nfast = xlate_nfast;
+        if (nlookups)
+            *nlookups = xlate_nlookups;
+    }
+
+private:
+    RSIM_Process::TranslatedBlockPtr xlate_block;       /**< Block being executed, or null. */
+    size_t xlate_index;                                 /**< Index of the current instruction in xlate_block. */
+    size_t xlate_generation;                            /**< Process translation generation when xlate_block was obtained. */
+    size_t xlate_nfast;                                 /**< Instructions returned from xlate_block by current_insn(). */
+    size_t xlate_nlookups;                              /**< Number of blocks looked up by current_insn(). */
+
 
     /**************************************************************************************************************************
      *                                  Dynamic Linking
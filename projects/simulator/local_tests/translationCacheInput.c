@@ -0,0 +1,104 @@
+/* Specimen for the translation cache test.  It runs code that it then changes in several ways (storing to it, reading over it
+ * with a system call, and mapping a file over it) and checks that the new instructions are executed each time. Each function
+ * is called many times so the simulator has a chance to translate and cache its block before it's changed.  Exits with
+ * non-zero status if any check fails, so the test also passes when the specimen runs natively. */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define PAGE_SIZE 4096
+#define NCALLS 100
+
+typedef int (*Function)(void);
+
+static int nerrors = 0;
+
+/* Emit "mov eax, VALUE" at CODE and return the address following it. */
+static unsigned char *
+emit_mov(unsigned char *code, int value)
+{
+    code[0] = 0xb8;
+    memcpy(code+1, &value, 4);
+    return code + 5;
+}
+
+/* Emit "ret" at CODE and return the address following it. */
+static unsigned char *
+emit_ret(unsigned char *code)
+{
+    code[0] = 0xc3;
+    return code + 1;
+}
+
+static void
+check(const char *what, unsigned char *code, int expected)
+{
+    Function f = (Function)code;
+    int i, got;
+    for (i=0; i<NCALLS; ++i) {
+        if ((got = f()) != expected) {
+            printf("%s: call #%d returned %d but expected %d\n", what, i, got, expected);
+            ++nerrors;
+            return;
+        }
+    }
+}
+
+int
+main(int argc, char *argv[])
+{
+    unsigned char buf[PAGE_SIZE], *page, *second;
+    FILE *file;
+    int fd;
+
+    page = mmap(NULL, PAGE_SIZE, PROT_READ|PROT_WRITE|PROT_EXEC, MAP_PRIVATE|MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED==page) {
+        perror("mmap");
+        return 1;
+    }
+
+    /* Store to the immediate operand of a cached instruction. */
+    emit_ret(emit_mov(page, 1));
+    check("initial code", page, 1);
+    page[1] = 2;
+    check("after storing to the operand", page, 2);
+
+    /* Store to the second instruction of a cached block without touching the first. */
+    second = emit_mov(page+64, 3);
+    emit_ret(emit_mov(second, 4));
+    check("two-instruction block", page+64, 4);
+    emit_mov(second, 5);
+    check("after storing to the second instruction", page+64, 5);
+
+    /* Replace the code with a system call that writes to memory, and then by mapping a file over the page. */
+    memset(buf, 0, sizeof buf);
+    emit_ret(emit_mov(buf, 6));
+    if (NULL==(file = tmpfile()) || 1!=fwrite(buf, sizeof buf, 1, file) || 0!=fflush(file)) {
+        perror("tmpfile");
+        return 1;
+    }
+    fd = fileno(file);
+    if (PAGE_SIZE!=pread(fd, page, PAGE_SIZE, 0)) {
+        perror("pread");
+        return 1;
+    }
+    check("after reading over the code", page, 6);
+
+    emit_ret(emit_mov(buf, 7));
+    if (0!=lseek(fd, 0, SEEK_SET) || PAGE_SIZE!=write(fd, buf, PAGE_SIZE)) {
+        perror("write");
+        return 1;
+    }
+    check("before mapping a file over the code", page, 6);
+    if (page!=mmap(page, PAGE_SIZE, PROT_READ|PROT_EXEC, MAP_PRIVATE|MAP_FIXED, fd, 0)) {
+        perror("mmap");
+        return 1;
+    }
+    check("after mapping a file over the code", page, 7);
+
+    fclose(file);
+    printf("%s: %d error%s\n", argv[0], nerrors, 1==nerrors?"":"s");
+    return nerrors ? 1 : 0;
+}
@@ -0,0 +1,126 @@
+#!/usr/bin/perl
+
+=head1 NAME
+
+compareBenchmarks.pl - merge and compare ROSE benchmark results
+
+=head1 SYNOPSIS
+
+compareBenchmarks.pl --merge RESULTS... >MERGED
+
+compareBenchmarks.pl [--threshold=PERCENT] [--min-seconds=SECONDS] BASELINE CURRENT
+
+=head1 DESCRIPTION
+
+The first form combines the JSON files produced by several runs of tests/PerformanceTests/roseBenchmarks into one file
+having the same format, which is written to standard output.  If the same benchmark name appears in more than one
+input then the last one wins.
+
+The second form compares the median wall-clock time of each benchmark in the CURRENT results with the same benchmark in
+the BASELINE results and prints a table.  A benchmark that is slower than the baseline by more than the threshold is
+reported as a regression, and one that is faster by more than the threshold is reported as an improvement. Benchmarks
+that appear in only one of the files are listed but are not errors.  The exit status is non-zero if there was any
+regression.
+
+This is the script behind "make bench" in the build tree.
+
+=over
+
+=item --threshold=PERCENT
+
+Relative change in median wall time that is considered significant. The default is 10 percent.
+
+=item --min-seconds=SECONDS
+
+Benchmarks whose baseline and current medians are both below this time are too fast to compare reliably and are never
+reported as regressions or improvements. The default is 0.005 seconds.
+
+=back
+
+=cut
+
+use strict;
+use Getopt::Long;
+use JSON::PP;
+
+my $threshold = 10;
+my $min_seconds = 0.005;
+my $merge;
+
+sub usage {
+  local $_ = `(pod2text $0) 2>/dev/null`;
+  die $_ || "see perldoc $0 for usage\n";
+}
+
+GetOptions("threshold=f" => \$threshold, "min-seconds=f" => \$min_seconds, "merge" => \$merge, "help|h" => \&usage)
+  or usage;
+
+# Reads a results file and returns the decoded JSON.
+sub load {
+  my($file) = @_;
+  open my $fh, "<", $file or die "$0: $file: $!\n";
+  local $/;
+  my $text = <$fh>;
+  close $fh;
+  my $results = eval { JSON::PP->new->decode($text) };
+  die "$0: $file: $@" if $@;
+  die "$0: $file: not a benchmark results file\n" unless ref $results eq 'HASH' && ref $results->{benchmarks} eq 'ARRAY';
+  return $results;
+}
+
+# Returns a hash that maps benchmark names to benchmarks.
+sub by_name {
+  my($results) = @_;
+  my %by_name = map {$_->{name} => $_} @{$results->{benchmarks}};
+  return \%by_name;
+}
+
+if ($merge) {
+  usage unless @ARGV;
+  my($merged, @order, %benchmarks);
+  for my $file (@ARGV) {
+    my $results = load $file;
+    $merged ||= $results;
+    for my $benchmark (@{$results->{benchmarks}}) {
+      push @order, $benchmark->{name} unless exists $benchmarks{$benchmark->{name}};
+      $benchmarks{$benchmark->{name}} = $benchmark;
+    }
+  }
+  $merged->{benchmarks} = [map {$benchmarks{$_}} @order];
+  print JSON::PP->new->canonical->pretty->encode($merged);
+  exit 0;
+}
+
+usage unless 2 == @ARGV;
+my($baseline, $current) = map {by_name load $_} @ARGV;
+my %names = map {$_ => 1} keys(%$baseline), keys(%$current);
+my $nregressions = 0;
+
+printf "%-32s %12s %12s %9s  %s\n", "benchmark", "baseline(s)", "current(s)", "change", "status";
+for my $name (sort keys %names) {
+  my $old = $baseline->{$name} && $baseline->{$name}{wall_seconds}{median};
+  my $new = $current->{$name} && $current->{$name}{wall_seconds}{median};
+  if (!defined $new) {
+    printf "%-32s %12.4f %12s %9s  %s\n", $name, $old, "-", "", "missing";
+  } elsif (!defined $old) {
+    printf "%-32s %12s %12.4f %9s  %s\n", $name, "-", $new, "", "new";
+  } else {
+    my $change = $old > 0 ? 100 * ($new - $old) / $old : 0;
+    my $status = "";
+    if ($old >= $min_seconds || $new >= $min_seconds) {
+      if ($change > $threshold) {
+        $status = "REGRESSION";
+        ++$nregressions;
+      } elsif ($change < -$threshold) {
+        $status = "improved";
+      }
+    }
+    printf "%-32s %12.4f %12.4f %+8.1f%%  %s\n", $name, $old, $new, $change, $status;
+  }
+}
+
+if ($nregressions) {
+  print "$nregressions benchmark", (1==$nregressions?" is":"s are"), " more than $threshold% slower than the baseline\n";
+  exit 1;
+}
+exit 0;
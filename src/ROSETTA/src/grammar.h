@@ -374,6 +374,9 @@ class Grammar
 
           StringUtility::FileWithLineNumbers buildStringForProcessDataMemberReferenceToPointersSource ( Terminal & node );
 
+       // Support for the nodeSize() and heapMemoryUsage() member functions used by rose::MemoryCensus
+          StringUtility::FileWithLineNumbers buildStringForHeapMemoryUsageSource ( Terminal & node );
+
        // DQ (3/7/2007): support for getChildIndex member function
           StringUtility::FileWithLineNumbers buildStringForGetChildIndexSource ( Terminal & node );
 
@@ -424,6 +427,8 @@ class Grammar
        // JJW (11/1/2008): Changed to process rather than return the references
           void buildStringForProcessDataMemberReferenceToPointersSupport( Terminal & node, StringUtility::FileWithLineNumbers & outputFile );
 
+          void buildStringForHeapMemoryUsageSupport( Terminal & node, StringUtility::FileWithLineNumbers & outputFile );
+
        // DQ (12/23/2005): Relocated copy function to a separate file to imrove readability of source code
           void buildCopyMemberFunctions( Terminal & node, StringUtility::FileWithLineNumbers & outputFile );
 
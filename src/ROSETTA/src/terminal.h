@@ -313,6 +313,9 @@ class Terminal
   std::string buildProcessDataMemberReferenceToPointers ();
   std::string buildListIteratorStringForReferenceToPointers(std::string typeName, std::string variableName, std::string classNameString, bool traverse);
 
+// Support for "size_t heapMemoryUsage() const", the heap memory owned by data members (see rose::MemoryCensus).
+  std::string buildHeapMemoryUsage ();
+
 // DQ (3/7/2007): Building support for "long getChildIndex();" to be use for "bool isChild();" and other purposes.
   std::string buildChildIndex ();
   std::string buildListIteratorStringForChildIndex(std::string typeName, std::string variableName, std::string classNameString);
@@ -41,6 +41,48 @@ public:
     /** Make an unknown instruction from an exception. */
     virtual SgAsmInstruction *make_unknown_instruction(const Exception&) ROSE_OVERRIDE;
 
+    /** Lightweight description of one instruction.
+     *
+     *  This is the result of the decode-only fast path, decodeInstruction().  It holds the instruction's size, kind, raw bytes
+     *  and relative branch target, which is all that is needed to find basic block boundaries and control flow successors.
+     *  No AST nodes are created; use materializeInstruction() to create the full SgAsmX86Instruction later if it's needed. */
+    struct DecodedInstruction {
+        rose_addr_t va;                                 /**< Address of the first byte of the instruction. */
+        X86InstructionKind kind;                        /**< Instruction kind, or x86_unknown_instruction if not decoded. */
+        size_t size;                                    /**< Size of the instruction in bytes; zero if not decoded. */
+        bool hasTarget;                                 /**< True if the instruction has a relative branch target. */
+        rose_addr_t target;                             /**< Branch target when @p hasTarget is set. */
+        uint8_t bytes[15];                              /**< Raw bytes of the instruction; only @p size are used. */
+
+        DecodedInstruction()
+            : va(0), kind(x86_unknown_instruction), size(0), hasTarget(false), target(0) {}
+
+        /** True if the fast path decoded the instruction. */
+        bool isValid() const { return size > 0; }
+
+        /** Same as SgAsmX86Instruction::terminatesBasicBlock. */
+        bool terminatesBasicBlock() const;
+
+        /** Same as SgAsmX86Instruction::getSuccessors(bool*). */
+        AddressSet getSuccessors(bool *complete) const;
+    };
+
+    /** Decode an instruction without building an AST.
+     *
+     *  The fast path handles the integer instructions that make up most compiled code. It returns false (and an invalid @p
+     *  decoded) for anything else, such as 16-bit code, instructions with repeat prefixes, floating-point and SIMD instructions,
+     *  invalid encodings, and short reads, in which case the caller should use disassembleOne(). When it returns true the size,
+     *  kind, and successors agree with what disassembleOne() would have produced.  This method does not modify the
+     *  disassembler and may be called concurrently from multiple threads.
+     *
+     * @{ */
+    bool decodeInstruction(const MemoryMap *map, rose_addr_t start_va, DecodedInstruction &decoded /*out*/) const;
+    bool decodeInstruction(rose_addr_t start_va, const uint8_t *buf, size_t bufsz, DecodedInstruction &decoded /*out*/) const;
+    /** @} */
+
+    /** Build the full instruction AST for an instruction found by decodeInstruction(). */
+    SgAsmX86Instruction *materializeInstruction(const DecodedInstruction&);
+
 
     /*========================================================================================================================
      * Data types
@@ -16,6 +16,7 @@ bool x86InstructionIsFloatingPoint(SgAsmX86Instruction*);
 bool x86InstructionIsConditionalFlagBitAndByte(SgAsmX86Instruction* inst);
 
 bool x86InstructionIsControlTransfer(SgAsmX86Instruction* inst);
+bool x86InstructionIsControlTransfer(X86InstructionKind kind);
 bool x86InstructionIsUnconditionalBranch(SgAsmX86Instruction* inst);
 bool x86InstructionIsConditionalBranch(SgAsmX86Instruction* inst);
 bool x86InstructionIsDataTransfer(SgAsmX86Instruction* inst);
@@ -13,6 +13,9 @@
 
 namespace rose {
 namespace BinaryAnalysis {
+
+class DominatorTree;
+
 namespace Partitioner2 {
 
 /** Control flow graph vertex. */
@@ -118,6 +121,21 @@ typedef std::list<ControlFlowGraph::EdgeNodeIterator> EdgeList;
 typedef std::list<ControlFlowGraph::ConstEdgeNodeIterator> ConstEdgeList;
 /** @} */
 
+/** Compute immediate dominators.
+ *
+ *  Computes the immediate dominator of every vertex reachable from @p root and stores the result in @p tree, which is indexed
+ *  by vertex ID.  The tree can be updated incrementally with DominatorTree::insert_edge as edges are added to the graph as long
+ *  as no vertices are erased (erasing a vertex changes the IDs of other vertices). */
+void buildDominatorTree(const ControlFlowGraph&, const ControlFlowGraph::ConstVertexNodeIterator &root,
+                        DominatorTree &tree /*out*/);
+
+/** Compute immediate post dominators.
+ *
+ *  Like @ref buildDominatorTree except the edges are followed backward from @p exit, which is usually a function's unique
+ *  return vertex or one of the special vertices such as the indeterminate vertex. */
+void buildPostDominatorTree(const ControlFlowGraph&, const ControlFlowGraph::ConstVertexNodeIterator &exit,
+                            DominatorTree &tree /*out*/);
+
 /** Base class for CFG-adjustment callbacks.
  *
  *  Users may create subclass objects from this class and pass their shared-ownership pointers to the partitioner, in which
@@ -11,6 +11,72 @@
 namespace rose {
 namespace BinaryAnalysis {
 
+class DisassemblerX86;
+
+/** Compact description of an instruction.
+ *
+ *  This is what an InstructionProvider stores when only the size, kind, and control flow successors of an instruction are
+ *  needed.  It is 24 bytes, compared to several hundred for an SgAsmInstruction with its operand expressions, raw bytes, and
+ *  other AST bookkeeping.  It stores no operands and no raw bytes; those are obtained by asking the instruction provider for
+ *  the full instruction, which is disassembled again from the memory map on demand.
+ *
+ *  Compact instructions are owned by the instruction provider that created them and are never modified or freed before the
+ *  provider is destroyed. */
+class CompactInstruction {
+public:
+    /** Bit flags. */
+    enum Flags {
+        UNKNOWN                 = 0x01,                 /**< Instruction could not be disassembled. */
+        TERMINATES_BLOCK        = 0x02,                 /**< Instruction terminates a basic block. */
+        HAS_TARGET              = 0x04,                 /**< Instruction has one successor other than the fall-through. */
+        FALLS_THROUGH           = 0x08,                 /**< Fall-through address is a successor. */
+        COMPLETE                = 0x10,                 /**< Successors are a complete list. */
+        EXACT_SUCCESSORS        = 0x20                  /**< Successors are representable by this object. */
+    };
+
+private:
+    rose_addr_t va_;
+    rose_addr_t target_;
+    unsigned kind_;
+    uint16_t size_;
+    uint8_t flags_;
+
+public:
+    CompactInstruction(): va_(0), target_(0), kind_(0), size_(0), flags_(0) {}
+
+    /** Describes a fully disassembled instruction. */
+    explicit CompactInstruction(SgAsmInstruction*);
+
+    /** Describes an instruction from its parts.  The @p successors and @p complete are the values that would be returned by
+     *  SgAsmInstruction::getSuccessors(bool*). */
+    CompactInstruction(rose_addr_t va, size_t size, unsigned kind, bool isUnknown, bool terminatesBlock,
+                       const Disassembler::AddressSet &successors, bool complete);
+
+    /** Starting address. */
+    rose_addr_t address() const { return va_; }
+
+    /** Size of instruction in bytes. */
+    size_t size() const { return size_; }
+
+    /** Architecture-specific instruction kind.  Same as SgAsmInstruction::get_anyKind. */
+    unsigned kind() const { return kind_; }
+
+    /** True if this is an "unknown" instruction.  See SgAsmInstruction::isUnknown. */
+    bool isUnknown() const { return 0 != (flags_ & UNKNOWN); }
+
+    /** True if the instruction terminates a basic block.  See SgAsmInstruction::terminatesBasicBlock. */
+    bool terminatesBasicBlock() const { return 0 != (flags_ & TERMINATES_BLOCK); }
+
+    /** True if getSuccessors() gives the same answer as SgAsmInstruction::getSuccessors(bool*).
+     *
+     *  This is false for the rare instructions whose successors are not the fall-through address plus at most one other
+     *  address, in which case the caller needs the full instruction. */
+    bool hasExactSuccessors() const { return 0 != (flags_ & EXACT_SUCCESSORS); }
+
+    /** Control flow successors.  See SgAsmInstruction::getSuccessors(bool*) and hasExactSuccessors(). */
+    Disassembler::AddressSet getSuccessors(bool *complete) const;
+};
+
 /** Provides and caches instructions.
  *
  *  This class returns an instruction for a given address, caching the instruction so that the same instruction is returned
@@ -27,18 +93,33 @@ class InstructionProvider: public Sawyer::SharedObject {
 public:
     typedef Sawyer::SharedPointer<InstructionProvider> Ptr;
     typedef Sawyer::Container::Map<rose_addr_t, SgAsmInstruction*> InsnMap;
+    typedef Sawyer::Container::Map<rose_addr_t, const CompactInstruction*> CompactMap;
 
 private:
+    // Arena for compact instructions. They're allocated in chunks and never freed individually.
+    class CompactArena {
+        std::vector<CompactInstruction*> chunks_;
+        size_t nUsed_;                                  // number of slots used in the last chunk
+        static const size_t chunkSize = 4096;           // instructions per chunk
+    public:
+        CompactArena(): nUsed_(chunkSize) {}
+        ~CompactArena();
+        const CompactInstruction* insert(const CompactInstruction&);
+    private:
+        CompactArena(const CompactArena&);              // not copyable
+        CompactArena& operator=(const CompactArena&);
+    };
+
     Disassembler *disassembler_;
+    const DisassemblerX86 *x86_;                        // disassembler_ if it has a decode-only fast path
     MemoryMap memMap_;
     mutable InsnMap insnMap_;                           // this is a cache
+    mutable CompactMap compactMap_;                     // compact instructions, also a cache
+    mutable CompactArena compactArena_;                 // storage for compactMap_ values
     bool useDisassembler_;
 
 protected:
-    InstructionProvider(Disassembler *disassembler, const MemoryMap &map)
-        : disassembler_(disassembler), memMap_(map), useDisassembler_(true) {
-        ASSERT_not_null(disassembler);
-    }
+    InstructionProvider(Disassembler *disassembler, const MemoryMap &map);
 
 public:
     /** Static allocating Constructor.
@@ -74,10 +155,20 @@ public:
      *  are not executable. */
     SgAsmInstruction* operator[](rose_addr_t va) const;
 
+    /** Returns a compact description of the instruction at the specified virtual address, or null.
+     *
+     *  This returns null in the same situations as operator[], and otherwise describes the same instruction, including the
+     *  "unknown" instructions.  It is much cheaper than operator[] when only the size, kind, or control flow successors are
+     *  needed: if the full instruction is already cached it's used; otherwise the decode-only fast path of the disassembler is
+     *  used if it has one, and if not, the instruction is disassembled, described, and then discarded.  In no case does this
+     *  method add an instruction to the cache used by operator[]. */
+    const CompactInstruction* compact(rose_addr_t va) const;
+
     /** Insert an instruction into the cache.
      *
      *  This instruction provider saves a pointer to the instruction without taking ownership.  If an instruction already
-     *  exists at the new instruction's address then the new instruction replaces the old instruction. */
+     *  exists at the new instruction's address then the new instruction replaces the old instruction, and the next call to
+     *  compact() for that address describes the new instruction. */
     void insert(SgAsmInstruction*);
 
     /** Returns the disassembler.
@@ -94,6 +185,11 @@ public:
      *  This is a constant-time operation. */
     size_t nCached() const { return insnMap_.size(); }
 
+    /** Returns number of cached compact starting addresses.
+     *
+     *  Like nCached(), this includes addresses where an instruction is known to not exist. */
+    size_t nCompact() const { return compactMap_.size(); }
+
     /** Returns the register dictionary. */
     const RegisterDictionary* registerDictionary() const { return disassembler_->get_registers(); }
 
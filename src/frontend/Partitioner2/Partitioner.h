@@ -572,6 +572,13 @@ public:
      *  then that same instruction will be returned this time. */
     SgAsmInstruction* discoverInstruction(rose_addr_t startVa) const /*final*/;
 
+    /** Discover a compact instruction.
+     *
+     *  Returns a compact description of the same instruction that @ref discoverInstruction would return, or null in the same
+     *  situations. This is intended for speculative searches that only need the instruction's size, kind, or successors since
+     *  it doesn't create or cache an AST for the instruction.  See InstructionProvider::compact. */
+    const CompactInstruction* discoverCompactInstruction(rose_addr_t startVa) const /*final*/;
+
     /** Cross references.
      *
      *  Scans all attached instructions looking for constants mentioned in the instructions and builds a mapping from those
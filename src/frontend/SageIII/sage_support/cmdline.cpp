@@ -11,6 +11,7 @@
 #include "cmdline.h"
 #include "keep_going.h"
 #include "Diagnostics.h"                                // rose::Diagnostics
+#include "AstConsistencyTests.h"                        // AstTests
 
 #include <boost/foreach.hpp>
 #include <boost/algorithm/string/replace.hpp>
@@ -307,6 +308,11 @@ CommandlineProcessing::isOptionTakingSecondParameter( string argument )
           argument == "-rose:output" ||                     // Used to specify output file to ROSE
           argument == "-rose:o" ||                          // Used to specify output file to ROSE (alternative to -rose:output)
           argument == "-rose:compilationPerformanceFile" || // Use to output performance information about ROSE compilation phases
+          argument == "-rose:profileTraceFile" ||           // Use to output a Chrome trace of ROSE processing phases
+          argument == "-rose:profileCsvFile" ||             // Use to output a CSV table of ROSE processing phases
+          argument == "-rose:astConsistencyThreads" ||      // Threads used to run the AST consistency tests
+          argument == "-rose:astConsistencySampling" ||     // Fraction of functions checked by the AST consistency tests
+          argument == "-rose:astConsistencySamplingSeed" || // Seed used to choose the sampled functions
           argument == "-rose:verbose" ||                    // Used to specify output of internal information about ROSE phases
           argument == "-rose:log" ||                        // Used to conntrol rose::Diagnostics
           argument == "-rose:test" ||
@@ -1463,6 +1469,42 @@ SgProject::processCommandLine(const vector<string>& input_argv)
           p_compilationPerformanceFile = compilationPerformanceFilenameParameter;
         }
 
+  // Support for hierarchical profiling of processing phases (see rose::PhaseProfiler); the files are written at exit.
+     std::string profileTraceFilenameParameter;
+     if ( CommandlineProcessing::isOptionWithParameter(local_commandLineArgumentList,
+          "-rose:","(profileTraceFile)",profileTraceFilenameParameter,true) == true )
+        {
+          rose::PhaseProfiler::traceFile(profileTraceFilenameParameter);
+        }
+     std::string profileCsvFilenameParameter;
+     if ( CommandlineProcessing::isOptionWithParameter(local_commandLineArgumentList,
+          "-rose:","(profileCsvFile)",profileCsvFilenameParameter,true) == true )
+        {
+          rose::PhaseProfiler::csvFile(profileCsvFilenameParameter);
+        }
+
+  // Support for running the AST consistency tests concurrently and on a sample of the functions (see AstTests::runAllTests()).
+     int astConsistencyThreadsParameter = 0;
+     if ( CommandlineProcessing::isOptionWithParameter(local_commandLineArgumentList,
+          "-rose:","(astConsistencyThreads)",astConsistencyThreadsParameter,true) == true )
+        {
+          AstTests::setNumberOfThreads(astConsistencyThreadsParameter > 0 ? astConsistencyThreadsParameter : 1);
+        }
+  // The seed is processed first since "astConsistencySampling" is a prefix of its option name.
+     int astConsistencySamplingSeedParameter = 0;
+     CommandlineProcessing::isOptionWithParameter(local_commandLineArgumentList,
+          "-rose:","(astConsistencySamplingSeed)",astConsistencySamplingSeedParameter,true);
+     float astConsistencySamplingParameter = 1.0;
+     if ( CommandlineProcessing::isOptionWithParameter(local_commandLineArgumentList,
+          "-rose:","(astConsistencySampling)",astConsistencySamplingParameter,true) == true )
+        {
+          AstTests::setSamplingRatio(astConsistencySamplingParameter,astConsistencySamplingSeedParameter);
+        }
+     if ( CommandlineProcessing::isOption(local_commandLineArgumentList,"-rose:","(astConsistencyTimingReport)",true) == true )
+        {
+          AstTests::setTimingReport(true);
+        }
+
   // DQ (1/30/2014): Added support to supress constant folding post-processing step (a performance problem on specific file of large applications).
      set_suppressConstantFoldingPostProcessing(false);
      ROSE_ASSERT (get_suppressConstantFoldingPostProcessing() == false);
@@ -3065,6 +3107,13 @@ SgFile::usage ( int status )
 "                             filename where compiler performance for internal\n"
 "                             phases (in CSV form) is placed for later\n"
 "                             processing (using script/graphPerformance)\n"
+"     -rose:profileTraceFile FILE\n"
+"                             filename where the wall clock time, CPU time,\n"
+"                             memory and IR node allocations of each internal\n"
+"                             phase are written when ROSE exits (in Chrome\n"
+"                             trace-event JSON form, see chrome://tracing)\n"
+"     -rose:profileCsvFile FILE\n"
+"                             same as -rose:profileTraceFile but in CSV form\n"
 "     -rose:exit_after_parser just call the parser (C, C++, and fortran only)\n"
 "     -rose:skip_syntax_check skip Fortran syntax checking (required for F2003 and Co-Array Fortran code\n"
 "                             when using gfortran versions greater than 4.1)\n"
@@ -3113,6 +3162,18 @@ SgFile::usage ( int status )
 "                             file format for binaries)\n"
 "     -rose:skipAstConsistancyTests\n"
 "                             skip AST consitancy testing (for better performance)\n"
+"     -rose:astConsistencyThreads N\n"
+"                             run the AST consistency tests that only read the\n"
+"                             AST using N threads (default is 1)\n"
+"     -rose:astConsistencySampling RATIO\n"
+"                             run the AST traversal consistency tests on only\n"
+"                             a random fraction RATIO (0.0 to 1.0) of the\n"
+"                             function definitions (default is 1.0)\n"
+"     -rose:astConsistencySamplingSeed N\n"
+"                             seed used to choose the sampled function\n"
+"                             definitions (default is a random seed)\n"
+"     -rose:astConsistencyTimingReport\n"
+"                             print the time used by each AST consistency test\n"
 "\n"
 "GNU g++ options recognized:\n"
 "     -ansi                   equivalent to -rose:strict\n"
@@ -5347,6 +5408,12 @@ SgFile::stripRoseCommandLineOptions ( vector<string> & argv )
      optionCount = sla(argv, "-rose:", "($)^", "(astMergeCommandFile)",filename,1);
      optionCount = sla(argv, "-rose:", "($)^", "(projectSpecificDatabaseFile)",filename,1);
      optionCount = sla(argv, "-rose:", "($)^", "(compilationPerformanceFile)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)^", "(profileTraceFile)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)^", "(profileCsvFile)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)^", "(astConsistencyThreads)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)^", "(astConsistencySamplingSeed)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)^", "(astConsistencySampling)",filename,1);
+     optionCount = sla(argv, "-rose:", "($)", "(astConsistencyTimingReport)",1);
 
          //AS(093007) Remove paramaters relating to excluding and include comments and directives
      optionCount = sla(argv, "-rose:", "($)^", "(excludeCommentsAndDirectives)", &integerOption, 1);
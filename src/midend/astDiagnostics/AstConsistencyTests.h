@@ -7,6 +7,10 @@
 // DQ (12/7/2003): use platform independent macro defined in config.h
 // #include IOSTREAM_HEADER_FILE
 #include <iostream>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
 
 #include "rosedll.h"
 #include "AstStatistics.h"
@@ -64,6 +68,43 @@ class ROSE_DLL_API AstTests
        //! Test codes that traverse the AST
           static void runAllTests(SgProject* sageProject);
           static bool isCorrectAst(SgProject* sageProject);
+
+       // Settings for runAllTests() (see the "-rose:astConsistency*" command line options).
+
+       //! Number of threads used to run the tests that only read the AST.  The default, one, runs all tests serially and
+       //! in their original order.  With more threads the read-only tests are run concurrently first and then the tests
+       //! that may modify shared state (mangled name caches, symbol table iterators, type tables) are run serially.
+          static void setNumberOfThreads(size_t n);
+          static size_t getNumberOfThreads();
+
+       //! Fraction of the SgFunctionDefinition subtrees checked by the AST traversal tests.  The default, 1.0, traverses
+       //! the whole AST.  A smaller ratio traverses a random subset of the function definitions chosen with the given
+       //! seed (zero chooses a random seed, which is reported when verbose).  Tests over the memory pools always check
+       //! every IR node.
+          static void setSamplingRatio(double ratio, int seed = 0);
+          static double getSamplingRatio();
+
+       //! Number of function definitions traversed, and number in the AST, by the most recent call to runAllTests().  Both
+       //! are zero unless that call sampled the function definitions.
+          static size_t getNumberOfSampledFunctions();
+          static size_t getNumberOfFunctionDefinitions();
+
+       //! Print the table of per-test times after each call to runAllTests() (also printed when verbose).
+          static void setTimingReport(bool enabled);
+
+       //! Elapsed time of a test in the most recent call to runAllTests().
+          struct TestTiming
+             {
+               std::string name;
+               double seconds;                          // elapsed wall clock time
+               double cpuSeconds;                       // CPU time used by the thread that ran the test
+               size_t thread;                           // zero for the calling thread
+               bool sampled;                            // test was restricted to the sampled function definitions
+             };
+
+       //! Per-test times from the most recent call to runAllTests(), in the order the tests finished.
+          static const std::vector<TestTiming> & getTestTimings();
+          static void printTimingTable(std::ostream & os);
    };
 
 #ifndef SWIG
@@ -335,6 +376,10 @@ class TestChildPointersInMemoryPool : public ROSE_VisitTraversal
           static void test();
 
           virtual void visit( SgNode * );
+
+     private:
+       // Children of each parent visited so far, built from the parent's data member pointers.
+          std::map<SgNode*,std::set<SgNode*> > childMap;
    };
 
 
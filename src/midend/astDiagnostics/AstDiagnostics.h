@@ -9,3 +9,9 @@
 
 // DQ (7/6/2005): Added to support performance analysis of ROSE.
 #include "AstPerformance.h"
+
+// Hierarchical profiling of processing phases (TimingPerformance objects are phases).
+#include "PhaseProfiler.h"
+
+// Memory used by each IR node class and each attribute name.
+#include "MemoryCensus.h"
@@ -15,6 +15,7 @@
 #endif
 
 #include <assert.h>
+#include <stddef.h>
 
 #include "rosedll.h"
 
@@ -225,6 +226,9 @@ class ROSE_DLL_API TimingPerformance : public AstPerformance
      private:
           RoseTimeType timer;
 
+       // Token of the corresponding rose::PhaseProfiler phase
+          size_t profilerPhase;
+
   // Used for timing compilation within ROSE
      public:
           TimingPerformance ( std::string s , bool outputReport = false );
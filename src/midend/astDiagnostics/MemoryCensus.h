@@ -0,0 +1,186 @@
+#ifndef ROSE_MEMORY_CENSUS_H
+#define ROSE_MEMORY_CENSUS_H
+
+#include <boost/cstdint.hpp>
+#include <boost/type_traits/is_scalar.hpp>
+#include <cstddef>
+#include <list>
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rosedll.h"
+
+class SgName;
+class rose_hash_multimap;
+class PreprocessingInfo;
+
+namespace rose {
+
+/** Memory used by each IR node class and by each kind of attribute.
+ *
+ *  ROSE_MemoryUsage and the phase profiler report only the resident set size of the whole process, and the memory pool
+ *  statistics (AstNodeStatistics) count only the fixed size of each node.  A census walks all memory pools and charges
+ *  each live IR node with its own size, the heap memory owned by its data members (vectors, lists, strings, symbol
+ *  tables, attached comments), and the attributes attached to it.  Attributes are also totaled by attribute name, since
+ *  those are often what grows in long-running analyses.
+ *
+ *  A snapshot can be taken at any point, such as before and after a processing phase, and two snapshots can be
+ *  subtracted to show what the phase added:
+ *
+ * @code
+ *  rose::MemoryCensus::Snapshot before = rose::MemoryCensus::take("after frontend");
+ *  runMyAnalysis(project);
+ *  rose::MemoryCensus::Snapshot after = rose::MemoryCensus::take("after analysis");
+ *  rose::MemoryCensus::emitReport(std::cout, after - before);
+ * @endcode
+ *
+ *  Heap sizes are estimates: they are computed from the sizes and capacities of the standard containers and do not
+ *  include allocator overhead.  A census traverses every IR node and is therefore about as expensive as numberOfNodes().
+ *  No other thread should be modifying the AST while a census is being taken. */
+namespace MemoryCensus {
+
+/** Memory used by the live IR nodes of one class.  Counts are signed so that differences between snapshots can be
+ *  represented. */
+struct ROSE_DLL_API ClassUsage {
+    std::string name;                                   /**< Name of the IR node class. */
+    boost::int64_t nNodes;                              /**< Number of live nodes. */
+    boost::int64_t nodeBytes;                           /**< Size of the nodes themselves. */
+    boost::int64_t heapBytes;                           /**< Heap memory owned by the data members of the nodes. */
+    boost::int64_t nAttributes;                         /**< Number of attributes attached to the nodes. */
+    boost::int64_t attributeBytes;                      /**< Memory used by those attributes and their containers. */
+
+    ClassUsage(): nNodes(0), nodeBytes(0), heapBytes(0), nAttributes(0), attributeBytes(0) {}
+
+    /** Total memory charged to this class. */
+    boost::int64_t totalBytes() const { return nodeBytes + heapBytes + attributeBytes; }
+};
+
+/** Memory used by all attributes having one name. */
+struct ROSE_DLL_API AttributeUsage {
+    std::string name;                                   /**< Name under which the attributes are stored. */
+    boost::int64_t nAttributes;                         /**< Number of attributes with this name. */
+    boost::int64_t bytes;                               /**< Memory used by the attributes, including their table entries. */
+
+    AttributeUsage(): nAttributes(0), bytes(0) {}
+};
+
+/** Results of one census. */
+struct ROSE_DLL_API Snapshot {
+    std::string label;                                  /**< Label supplied when the census was taken. */
+    std::vector<ClassUsage> classes;                    /**< Usage per IR node class, sorted by class name. */
+    std::vector<AttributeUsage> attributes;             /**< Usage per attribute name, sorted by name. */
+    boost::int64_t poolBytes;                           /**< Memory allocated for all memory pools, including unused slots. */
+    boost::int64_t residentKb;                          /**< Resident set size of the process. */
+    boost::int64_t attributeTableBytes;                 /**< Attribute tables and name registry shared by all nodes. */
+
+    Snapshot(): poolBytes(0), residentKb(0), attributeTableBytes(0) {}
+
+    /** Sum over all classes. */
+    ClassUsage total() const;
+
+    /** Usage of a class by name, or a zero usage if the class has no live nodes. */
+    ClassUsage find(const std::string &className) const;
+
+    /** Usage of an attribute by name, or a zero usage if there are no such attributes. */
+    AttributeUsage findAttribute(const std::string &attributeName) const;
+};
+
+/** Walks the memory pools and returns the memory used by each IR node class and each attribute name. */
+ROSE_DLL_API Snapshot take(const std::string &label = "");
+
+/** Difference between two snapshots, @p after minus @p before.  Classes and attributes that are unchanged are omitted.
+ *  The label of the result is "before..after". */
+ROSE_DLL_API Snapshot operator-(const Snapshot &after, const Snapshot &before);
+
+/** Writes a snapshot as JSON: an object with the label, totals, and arrays of classes and attributes. */
+ROSE_DLL_API void emitJson(std::ostream&, const Snapshot&);
+
+/** Writes a snapshot as CSV, one row per class followed by one row per attribute name, with a header row. */
+ROSE_DLL_API void emitCsv(std::ostream&, const Snapshot&);
+
+/** Writes the classes and attributes that use the most memory as human-readable tables.  At most @p maxRows rows are
+ *  written in each table. */
+ROSE_DLL_API void emitReport(std::ostream&, const Snapshot&, size_t maxRows = 30);
+
+/** Heap memory owned by a value.  These overloads are used by the ROSETTA-generated SgNode::heapMemoryUsage() functions,
+ *  which call heapBytes() for each data member, and may be used by AstAttribute::memoryUsage() implementations. Scalars,
+ *  pointers, and any type without a more specific overload own nothing.
+ * @{ */
+template<class T>
+size_t heapBytes(const T&) {
+    return 0;
+}
+
+ROSE_DLL_API size_t heapBytes(const std::string&);
+ROSE_DLL_API size_t heapBytes(const SgName&);
+ROSE_DLL_API size_t heapBytes(rose_hash_multimap*);   // owned by SgSymbolTable
+ROSE_DLL_API size_t heapBytes(std::vector<PreprocessingInfo*>*); // owned by SgLocatedNode
+
+template<class T, class A> size_t heapBytes(const std::vector<T, A>&);
+template<class T, class A> size_t heapBytes(const std::list<T, A>&);
+template<class T, class C, class A> size_t heapBytes(const std::set<T, C, A>&);
+template<class K, class V, class C, class A> size_t heapBytes(const std::map<K, V, C, A>&);
+template<class K, class V, class C, class A> size_t heapBytes(const std::multimap<K, V, C, A>&);
+template<class T, class U> size_t heapBytes(const std::pair<T, U>&);
+
+// Per-node overhead of the red-black tree nodes used by std::set and std::map (color and three links) and of the
+// doubly linked std::list nodes.
+static const size_t treeNodeOverhead = 4 * sizeof(void*);
+static const size_t listNodeOverhead = 2 * sizeof(void*);
+
+template<class T, class A>
+size_t heapBytes(const std::vector<T, A> &v) {
+    size_t bytes = v.capacity() * sizeof(T);
+    if (!boost::is_scalar<T>::value) {
+        for (typename std::vector<T, A>::const_iterator i=v.begin(); i!=v.end(); ++i)
+            bytes += heapBytes(*i);
+    }
+    return bytes;
+}
+
+template<class T, class A>
+size_t heapBytes(const std::list<T, A> &x) {
+    size_t bytes = 0;
+    for (typename std::list<T, A>::const_iterator i=x.begin(); i!=x.end(); ++i)
+        bytes += listNodeOverhead + sizeof(T) + heapBytes(*i);
+    return bytes;
+}
+
+template<class T, class C, class A>
+size_t heapBytes(const std::set<T, C, A> &x) {
+    size_t bytes = 0;
+    for (typename std::set<T, C, A>::const_iterator i=x.begin(); i!=x.end(); ++i)
+        bytes += treeNodeOverhead + sizeof(T) + heapBytes(*i);
+    return bytes;
+}
+
+template<class K, class V, class C, class A>
+size_t heapBytes(const std::map<K, V, C, A> &x) {
+    size_t bytes = 0;
+    for (typename std::map<K, V, C, A>::const_iterator i=x.begin(); i!=x.end(); ++i)
+        bytes += treeNodeOverhead + sizeof(*i) + heapBytes(i->first) + heapBytes(i->second);
+    return bytes;
+}
+
+template<class K, class V, class C, class A>
+size_t heapBytes(const std::multimap<K, V, C, A> &x) {
+    size_t bytes = 0;
+    for (typename std::multimap<K, V, C, A>::const_iterator i=x.begin(); i!=x.end(); ++i)
+        bytes += treeNodeOverhead + sizeof(*i) + heapBytes(i->first) + heapBytes(i->second);
+    return bytes;
+}
+
+template<class T, class U>
+size_t heapBytes(const std::pair<T, U> &x) {
+    return heapBytes(x.first) + heapBytes(x.second);
+}
+/** @} */
+
+} // namespace
+} // namespace
+
+#endif
@@ -0,0 +1,136 @@
+#ifndef ROSE_PHASE_PROFILER_H
+#define ROSE_PHASE_PROFILER_H
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "rosedll.h"
+
+namespace rose {
+
+/** Hierarchical, thread-aware profiling of processing phases.
+ *
+ *  A phase is a named interval of execution, usually the lifetime of a PhaseProfiler::Scope object.  Phases nest: a phase
+ *  that begins while another phase of the same thread is open becomes its child.  For each phase the profiler records the
+ *  elapsed wall clock time, the CPU time used by the thread, the change in resident set size, the number of IR nodes that
+ *  were allocated, and any user-defined counters that were incremented while the phase was the innermost open phase of its
+ *  thread.
+ *
+ *  Every TimingPerformance object is also a phase, so the frontend, the AST fixups and post-processing, the unparser, and
+ *  the backend compilation are all profiled without any further instrumentation.  Profiling is disabled by default. It is
+ *  enabled by the "-rose:profileTraceFile FILE" and "-rose:profileCsvFile FILE" command-line switches, which cause a Chrome
+ *  trace-event JSON file (viewable with chrome://tracing) or a CSV file to be written when the program exits, or by calling
+ *  enable().  frontend() looks for these switches before it starts its first timer, so the whole frontend is profiled.
+ *
+ *  Each thread records into its own buffer, so recording takes no locks.  The emit functions and phases() read all buffers
+ *  and should be called only when no other thread is recording.
+ *
+ * @code
+ *  void analyze(SgProject *project) {
+ *      rose::PhaseProfiler::Scope phase("my analysis");
+ *      for (...) {
+ *          ...
+ *          rose::PhaseProfiler::addToCounter("functions", 1);
+ *      }
+ *  }
+ * @endcode */
+namespace PhaseProfiler {
+
+/** Resources used by the process at a point in time. */
+struct ROSE_DLL_API Sample {
+    double wallTime;                                    /**< Wall clock time in seconds since the Unix epoch. */
+    double cpuTime;                                     /**< CPU seconds used by the calling thread. */
+    long residentKb;                                    /**< Resident set size of the process in kilobytes. */
+    size_t nodesAllocated;                              /**< IR nodes allocated by the process so far. */
+
+    Sample(): wallTime(0.0), cpuTime(0.0), residentKb(0), nodesAllocated(0) {}
+
+    /** Measure the current resources. */
+    static Sample now();
+};
+
+/** A recorded phase. */
+struct ROSE_DLL_API Phase {
+    std::string name;                                   /**< Name of the phase. */
+    unsigned thread;                                    /**< Profiler thread number, starting at zero. */
+    unsigned depth;                                     /**< Number of enclosing phases of the same thread. */
+    bool isOpen;                                        /**< True until the phase ends. */
+    Sample begin;                                       /**< Resources when the phase began. */
+    Sample end;                                         /**< Resources when the phase ended. */
+    std::vector<std::pair<std::string, double> > counters; /**< User-defined counters. */
+
+    Phase(): thread(0), depth(0), isOpen(false) {}
+
+    double wallTime() const { return end.wallTime - begin.wallTime; }
+    double cpuTime() const { return end.cpuTime - begin.cpuTime; }
+    long residentDeltaKb() const { return end.residentKb - begin.residentKb; }
+    size_t nodesAllocated() const { return end.nodesAllocated - begin.nodesAllocated; }
+};
+
+/** Enables or disables recording.  Phases that begin while recording is disabled are not recorded.  The setting may be
+ *  changed at any time, but a thread may not see the change until it next begins a phase, so recording should normally be
+ *  enabled before other threads start.
+ * @{ */
+ROSE_DLL_API void enable(bool b = true);
+ROSE_DLL_API bool isEnabled();
+/** @} */
+
+/** Begins a phase in the calling thread and returns a token for endPhase().  The returned token is invalid if recording is
+ *  disabled, in which case endPhase() does nothing. */
+ROSE_DLL_API size_t beginPhase(const std::string &name);
+
+/** Ends a phase that was begun by the calling thread.  Ending a phase that has already ended has no effect. */
+ROSE_DLL_API void endPhase(size_t token);
+
+/** Adds @p delta to a counter of the innermost open phase of the calling thread.  Nothing happens if the thread has no open
+ *  phase. */
+ROSE_DLL_API void addToCounter(const std::string &name, double delta);
+
+/** Returns a copy of all phases recorded by all threads, ordered by thread and then by the time at which they began. */
+ROSE_DLL_API std::vector<Phase> phases();
+
+/** Discards all recorded phases.  No phases should be open. */
+ROSE_DLL_API void clear();
+
+/** Writes the phases as Chrome trace-event JSON.  Each phase is a complete ("X") event whose arguments are the CPU time,
+ *  the resident set size and its change, the number of IR nodes allocated, and the user-defined counters. */
+ROSE_DLL_API void emitChromeTrace(std::ostream&);
+
+/** Writes the phases as CSV, one row per phase with a header row. */
+ROSE_DLL_API void emitCsv(std::ostream&);
+
+/** Writes the phases as an indented, human-readable report. */
+ROSE_DLL_API void emitReport(std::ostream&);
+
+/** Names of files to which the Chrome trace or CSV is written when the program exits.  Setting a non-empty name also
+ *  enables recording.
+ * @{ */
+ROSE_DLL_API void traceFile(const std::string&);
+ROSE_DLL_API void csvFile(const std::string&);
+/** @} */
+
+/** Enables recording if the command line has the "-rose:profileTraceFile" or "-rose:profileCsvFile" switches.  The
+ *  switches are left in @p argv for SgProject, which also recognizes them.  The first element is the program name. */
+ROSE_DLL_API void processCommandLine(const std::vector<std::string> &argv);
+
+/** A phase that begins when this object is constructed and ends when it is destroyed or when end() is called. */
+class ROSE_DLL_API Scope {
+    size_t token_;
+public:
+    explicit Scope(const std::string &name): token_(beginPhase(name)) {}
+    ~Scope() { endPhase(token_); }
+
+    /** End the phase before this object is destroyed. */
+    void end() { endPhase(token_); }
+private:
+    Scope(const Scope&);
+    Scope& operator=(const Scope&);
+};
+
+} // namespace
+} // namespace
+
+#endif
@@ -4,9 +4,14 @@
 #ifndef ASTATTRIBUTEMECHANISM_H
 #define ASTATTRIBUTEMECHANISM_H
 
+#include <cstddef>
+#include <iterator>
 #include <list>
+#include <set>
+#include <string>
+#include <utility>
+#include <vector>
 
-#include "AttributeMechanism.h"
 #include "rosedll.h"
 #include "rose_override.h"
 
@@ -73,6 +78,12 @@ class ROSE_DLL_API AstAttribute
           virtual char* packed_data();
           virtual void unpacked_data( int size, char* data );
 
+      /*! Number of bytes used by this attribute, including heap memory that it owns.  This is what rose::MemoryCensus
+          charges for the attribute.  The default is sizeof(AstAttribute) plus packed_size(); attributes that own
+          containers or strings should override it.
+       */
+          virtual size_t memoryUsage();
+
        // DQ (7/4/2008): Added DOT support.
           virtual std::string additionalNodeOptions();
        // virtual std::string additionalEdgeInfo();
@@ -170,23 +181,156 @@ class ROSE_DLL_API MetricAttribute : public AstAttribute
 };
 
 
-// DQ (6/28/2008):
-// Since this is implemented using AttributeMechanism which is derived from
-// std::map<Key,Value>, "Value" is a template parameter for "AstAttribute*"
-// And so the copy constructor will copy the pointer.  This is OK, but it
-// means that the AstAttribute objects are shared.  Alternatively, a copy
-// constructor implemented in this class could be implemented to support
-// deep copies.  This might be a good idea.
-class AstAttributeMechanism : public AttributeMechanism<std::string,AstAttribute*>
+/** Container for the attributes attached to one IR node.
+ *
+ *  Attributes are named by strings, but each name is registered once in a global registry that assigns it a small
+ *  integer ID.  The attribute pointers do not live in the container: there is one dense table per attribute ID, shared by
+ *  all containers and indexed by a slot number that each container is assigned when it is constructed.  Looking up an
+ *  attribute by ID is therefore two vector indexings, and a container holds only the short list of IDs that are present
+ *  instead of a string-keyed map.
+ *
+ *  Code that looks up attributes in hot loops should obtain the ID once and use the ID-based functions, which are also
+ *  available on the IR nodes themselves:
+ *
+ * @code
+ *  static const AstAttributeMechanism::AttributeId depthId = AstAttributeMechanism::attributeId("depth");
+ *  node->setAttribute(depthId, new AstIntAttribute(depth));
+ *  AstIntAttribute *attr = dynamic_cast<AstIntAttribute*>(node->getAttribute(depthId));
+ * @endcode
+ *
+ *  The string-based functions are kept for compatibility with the original map-based interface and cost one registry
+ *  lookup each.  Iteration and getAttributeIdentifiers() visit the attributes in order of their names, as before.
+ *
+ *  Copying a container makes deep copies of its attributes (see AstAttribute::copy), but destroying a container does not
+ *  delete them.
+ *
+ *  Thread safety: Different containers may be used concurrently.  Reading an attribute and looking up a name or an ID
+ *  take no lock when compiled with GCC 4.7 or later, since the registry and the tables only grow and a table that is
+ *  replaced by a larger one is kept for the readers that might still be using it.  Constructing and destroying
+ *  containers, registering names, and adding and removing attributes take a lock.  A single container is not
+ *  thread-safe. */
+class ROSE_DLL_API AstAttributeMechanism
    {
      public:
+       //! Integer that identifies an attribute name.
+          typedef size_t AttributeId;
+
+       //! ID that is never assigned to any name.
+          static const AttributeId INVALID_ID = (size_t)(-1);
+
+          typedef std::set<std::string> AttributeIdentifiers;
+
+       //! Iterates over the attributes in order of their names, yielding (name, attribute) pairs.
+          class ROSE_DLL_API iterator
+             {
+               public:
+                    typedef std::forward_iterator_tag iterator_category;
+                    typedef std::pair<std::string,AstAttribute*> value_type;
+                    typedef ptrdiff_t difference_type;
+                    typedef const value_type* pointer;
+                    typedef const value_type& reference;
+
+                    iterator();
+                    const value_type& operator*() const { return value; }
+                    const value_type* operator->() const { return &value; }
+                    iterator& operator++();
+                    iterator operator++(int);
+                    bool operator==(const iterator &other) const;
+                    bool operator!=(const iterator &other) const { return !(*this == other); }
+
+               private:
+                    friend class AstAttributeMechanism;
+                    iterator(const AstAttributeMechanism *mechanism, size_t index);
+                    void load();
+
+                    const AstAttributeMechanism *mechanism;
+                    size_t index;
+                    value_type value;
+             };
+          typedef iterator const_iterator;
+
+          AstAttributeMechanism ();
+
        // DQ (7/27/2008): Build a copy constructor that will do a deep copy
        // instead of calling the default copy constructor.
           AstAttributeMechanism ( const AstAttributeMechanism & X );
+          AstAttributeMechanism & operator= ( const AstAttributeMechanism & X );
 
-       // DQ (7/27/2008): Because we add an explicit copy constructor we
-       // now need an explicit default constructor.
-          AstAttributeMechanism ();
+       //! Releases this container's slot in the attribute tables; the attributes themselves are not deleted.
+         ~AstAttributeMechanism ();
+
+       /*! \brief ID for an attribute name, registering the name if this is its first use.
+
+           IDs are dense, starting at zero, and never change for the lifetime of the process.
+        */
+          static AttributeId attributeId(const std::string & name);
+
+       //! ID for an attribute name, or INVALID_ID if the name has never been registered.
+          static AttributeId findAttributeId(const std::string & name);
+
+       //! Name that was registered for an ID.
+          static std::string attributeName(AttributeId id);
+
+       //! Number of attribute names that have been registered.
+          static size_t numberOfAttributeIds();
+
+       //! Memory used by the registry and the attribute tables shared by all containers.
+          static size_t tableMemoryUsage();
+
+       //! Slot of this container in the attribute tables; unique among live containers and constant for its lifetime.
+          size_t slot() const { return p_slot; }
+
+       //! Memory used by this container, not counting the attributes or its share of the tables.
+          size_t memoryUsage() const;
+
+       //! Attribute with the specified ID, or NULL if there is none.
+          AstAttribute* get(AttributeId id) const;
+
+       //! Adds or replaces the attribute with the specified ID.
+          void set(AttributeId id, AstAttribute* data);
+
+       //! Test if an attribute with the specified ID is present.
+          bool exists(AttributeId id) const;
+
+       //! Removes the attribute with the specified ID and returns true, or returns false if it is not present.
+          bool remove(AttributeId id);
+
+       //! test if attribute "name" exists (i.e. has been added with add or set)
+          bool exists(const std::string & name) const;
+
+       //! add a new attribute. If attribute already exists, fail.
+          void add(const std::string & name, AstAttribute* data);
+
+       //! replace an existing attribute "name", fail if the attribute does not exist
+          void replace(const std::string & name, AstAttribute* data);
+
+       //! remove an existing attribute name, fail if the attribute does not exist
+          void remove(const std::string & name);
+
+       //! Set a value data for attribute name. If the attribute exists
+       //! it is replaced, otherwise it is added.
+          void set(const std::string & name, AstAttribute* data);
+
+       //! access the value of attribute "name". Fails if the attribute does not exist.
+          AstAttribute* operator[](const std::string & name) const;
+
+       //! get the set of all attribute identifiers/names
+          AttributeIdentifiers getAttributeIdentifiers() const;
+
+       //! Number of attributes in the container.
+          int size() const { return p_ids.size(); }
+
+       //! IDs of the attributes in the container, in no particular order.
+          const std::vector<AttributeId> & getAttributeIds() const { return p_ids; }
+
+          iterator begin();
+          iterator end();
+
+     private:
+          void copyAttributes(const AstAttributeMechanism & X);
+
+          size_t p_slot;
+          std::vector<AttributeId> p_ids;                   // attributes present, sorted by name when iterating
    };
 
 
@@ -205,6 +349,7 @@ class ROSE_DLL_API AstRegExAttribute : public AstAttribute
           AstRegExAttribute();
           AstRegExAttribute(const std::string & s);
           virtual AstAttribute* copy() ROSE_OVERRIDE;
+          virtual size_t memoryUsage() ROSE_OVERRIDE;
    };
 
 // PC (10/21/2012): Added new kind of attribute for handling regex trees.
@@ -225,6 +370,7 @@ class ROSE_DLL_API AstSgNodeAttribute : public AstAttribute
           AstSgNodeAttribute();
           AstSgNodeAttribute(SgNode *node);
           virtual AstAttribute* copy() ROSE_OVERRIDE;
+          virtual size_t memoryUsage() ROSE_OVERRIDE;
    };
 
 class ROSE_DLL_API AstSgNodeListAttribute : public AstAttribute
@@ -242,6 +388,7 @@ class ROSE_DLL_API AstSgNodeListAttribute : public AstAttribute
           AstSgNodeListAttribute(std::vector<SgNode *> &);
 
           virtual AstAttribute* copy() ROSE_OVERRIDE;
+          virtual size_t memoryUsage() ROSE_OVERRIDE;
    };
 
 class ROSE_DLL_API AstIntAttribute : public AstAttribute
@@ -254,6 +401,7 @@ class ROSE_DLL_API AstIntAttribute : public AstAttribute
           AstIntAttribute(int value_);
 
           virtual AstAttribute* copy() ROSE_OVERRIDE;
+          virtual size_t memoryUsage() ROSE_OVERRIDE;
    };
 
 class ROSE_DLL_API AstParameterizedTypeAttribute : public AstAttribute {
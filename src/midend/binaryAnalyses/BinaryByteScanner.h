@@ -0,0 +1,161 @@
+#ifndef ROSE_BinaryAnalysis_ByteScanner_H
+#define ROSE_BinaryAnalysis_ByteScanner_H
+
+#include <MemoryMap.h>
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace rose {
+namespace BinaryAnalysis {
+
+/** Vectorized scanning of memory.
+ *
+ *  These functions scan contiguous byte buffers for bytes that are (or are not) members of a set, several bytes at a time
+ *  using SIMD instructions when they are available.  They are the inner loops of analyses such as @ref StringFinder and
+ *  @ref MagicSignatures that need to look at every byte of large specimens such as firmware dumps.
+ *
+ *  The SIMD implementations are selected when the library is compiled: SSE2 is used if the compiler targets it (which is
+ *  always the case for x86-64), and AVX2 is used if the library is compiled with AVX2 enabled (e.g., <code>-mavx2</code>).
+ *  A scalar implementation is always available and is used on other architectures. */
+namespace ByteScanner {
+
+/** Instruction set used by the scanning loops. */
+enum Implementation {
+    SCALAR,                                             /**< One byte at a time. */
+    SSE2,                                               /**< Sixteen bytes at a time. */
+    AVX2                                                /**< Thirty-two bytes at a time. */
+};
+
+/** Best implementation available in this library. */
+Implementation bestImplementation();
+
+/** Name of an implementation. */
+std::string implementationName(Implementation);
+
+/** Set of byte values.
+ *
+ *  The set is stored as a bitmap for the scalar implementation and as a list of inclusive ranges of values for the SIMD
+ *  implementations.  Sets that have more than @ref maxSimdRanges ranges are always scanned one byte at a time. */
+class ByteSet {
+public:
+    /** Inclusive range of byte values. */
+    typedef std::pair<uint8_t, uint8_t> Range;
+
+    /** Maximum number of ranges for the SIMD implementations. */
+    static const size_t maxSimdRanges = 16;
+
+private:
+    uint32_t bits_[8];
+    std::vector<Range> ranges_;
+
+public:
+    /** Construct an empty set. */
+    ByteSet() { clear(); }
+
+    /** Remove all members. */
+    void clear();
+
+    /** Insert a value or an inclusive range of values.
+     *
+     * @{ */
+    void insert(uint8_t value) { insert(value, value); }
+    void insert(uint8_t least, uint8_t greatest);
+    /** @} */
+
+    /** True if the value is a member. */
+    bool contains(uint8_t value) const {
+        return 0 != (bits_[value >> 5] & ((uint32_t)1 << (value & 31)));
+    }
+
+    /** True if the set has no members. */
+    bool isEmpty() const { return ranges_.empty(); }
+
+    /** Members as a sorted list of non-adjacent ranges. */
+    const std::vector<Range>& ranges() const { return ranges_; }
+
+    /** Superset having few ranges.
+     *
+     *  Returns a set that contains all members of this set and has at most @p maxRanges ranges, formed by filling the
+     *  smallest gaps between ranges.  This is useful for prefilters, which may report false positives but should be
+     *  scanned with SIMD instructions. */
+    ByteSet superset(size_t maxRanges = maxSimdRanges) const;
+};
+
+/** Number of leading bytes that are members of the set.
+ *
+ *  Returns the offset of the first byte that is not a member, or @p size if all bytes are members.  An implementation that
+ *  is not compiled into the library is replaced by @ref bestImplementation. */
+size_t span(const uint8_t *data, size_t size, const ByteSet&, Implementation = bestImplementation());
+
+/** Number of leading bytes that are not members of the set.
+ *
+ *  Returns the offset of the first byte that is a member, or @p size if no bytes are members.  An implementation that is
+ *  not compiled into the library is replaced by @ref bestImplementation. */
+size_t find(const uint8_t *data, size_t size, const ByteSet&, Implementation = bestImplementation());
+
+/** Visit memory a buffer at a time.
+ *
+ *  Calls @p functor for each part of the constrained memory in address order, passing the starting address, a pointer to
+ *  the bytes, and the number of bytes.  The pointer points directly into the segment's buffer when the buffer exposes its data
+ *  (allocating, static, and memory-mapped buffers all do) so nothing is copied; otherwise the bytes are read into a temporary
+ *  buffer in chunks.  Consecutive calls may describe adjacent addresses from different segments, which callers that track
+ *  state across buffers can detect by comparing addresses.  Traversal stops early if the functor returns false. */
+template<class Functor>
+void forEachBuffer(MemoryMap::ConstConstraints where, Functor &functor, Sawyer::Container::MatchFlags flags=0);
+
+// Implementation details of forEachBuffer
+template<class Functor>
+struct BufferVisitor {
+    Functor &functor;
+    std::vector<uint8_t> chunk;
+    explicit BufferVisitor(Functor &functor): functor(functor) {}
+    bool operator()(const MemoryMap::Super &map, const AddressInterval &interval) {
+        MemoryMap::Super::ConstNodeIterator node = map.find(interval.least());
+        ASSERT_require(node != map.nodes().end());
+        const MemoryMap::Segment &segment = node->value();
+        rose_addr_t offset = segment.offset() + (interval.least() - node->key().least());
+        if (const uint8_t *data = segment.buffer()->data()) {
+            rose_addr_t va = interval.least();
+            rose_addr_t remaining = interval.greatest() - interval.least();   // one less than size, which might overflow
+            while (true) {
+                size_t n = (size_t)std::min(remaining, (rose_addr_t)(size_t)(-2)) + 1;
+                if (!functor(va, data + offset, n))
+                    return false;
+                if (n - 1 == remaining)
+                    return true;
+                va += n;
+                offset += n;
+                remaining -= n;
+            }
+        }
+        chunk.resize(65536);
+        rose_addr_t va = interval.least();
+        while (true) {
+            size_t n = (size_t)std::min((rose_addr_t)chunk.size() - 1, interval.greatest() - va) + 1;
+            n = segment.buffer()->read(&chunk[0], offset, n);
+            if (0 == n)
+                return true;                            // buffer is shorter than the segment
+            if (!functor(va, &chunk[0], n))
+                return false;
+            if (va + (n - 1) == interval.greatest())
+                return true;
+            va += n;
+            offset += n;
+        }
+    }
+};
+
+template<class Functor>
+void
+forEachBuffer(MemoryMap::ConstConstraints where, Functor &functor, Sawyer::Container::MatchFlags flags) {
+    BufferVisitor<Functor> visitor(functor);
+    where.traverse(visitor, flags);
+}
+
+} // namespace
+} // namespace
+} // namespace
+
+#endif
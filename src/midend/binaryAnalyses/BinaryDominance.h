@@ -9,6 +9,104 @@
 namespace rose {
 namespace BinaryAnalysis {
 
+/** Compact immediate dominator tree over integer vertex IDs.
+ *
+ *  This is the low-level dominator representation used when control flow graphs are too large for the iterative algorithm
+ *  in Dominance::build_idom_relation_from_cfg(), such as obfuscated functions having hundreds of thousands of basic blocks.
+ *  The graph is described only by a vertex count and a list of edges between vertex IDs; no AST nodes are involved and
+ *  nothing is written to the AST.  The result is a vector indexed by vertex ID whose values are immediate dominator IDs, so
+ *  it can be used with Boost graphs whose vertex descriptors are integers as well as with
+ *  rose::BinaryAnalysis::Partitioner2::ControlFlowGraph (see Partitioner2::buildDominatorTree()).
+ *
+ *  Dominators are computed by the SEMI-NCA algorithm from "Finding Dominators in Practice" by Loukas Georgiadis, Robert
+ *  E. Tarjan, and Renato F. Werneck.  It computes semidominators like Lengauer-Tarjan, then finds each immediate dominator as
+ *  the nearest common ancestor of its semidominator and DFS parent.  Its worst case is O(n^2) but in practice it runs in
+ *  near-linear time, and it needs no recursion so deep graphs don't exhaust the stack.
+ *
+ *  Edges can also be added after the tree is built, in which case insert_edge() updates the tree incrementally using the
+ *  depth-based search of Georgiadis, Italiano, Laura, and Santaroni ("An Experimental Study of Dynamic Dominators"). Only an
+ *  edge that makes a previously unreachable vertex reachable causes the tree to be recomputed from scratch.
+ *
+ *  Post dominators are obtained by adding each edge in reverse and using the exit vertex as the root.
+ *
+ *  @code
+ *  DominatorTree dt(nvertices);
+ *  dt.add_edge(0, 1);
+ *  dt.add_edge(1, 2);
+ *  dt.add_edge(0, 2);
+ *  dt.build(0);
+ *  assert(dt.idom(2) == 0);
+ *  dt.insert_edge(2, 1);           // incremental update
+ *  @endcode */
+class DominatorTree {
+public:
+    /** Value stored for vertices having no immediate dominator. */
+    static const size_t NO_VERTEX;
+
+    /** Construct a tree for a graph with the specified number of vertices and no edges. */
+    explicit DominatorTree(size_t nvertices=0) { reset(nvertices); }
+
+    /** Remove all edges and results and set the number of vertices. */
+    void reset(size_t nvertices);
+
+    /** Number of vertices. */
+    size_t nvertices() const { return succs_.size(); }
+
+    /** Add a control flow edge without updating the tree.
+     *
+     *  This is how the graph is described before calling build().  Self edges and parallel edges are permitted. */
+    void add_edge(size_t source, size_t target);
+
+    /** Compute dominators for all vertices reachable from the specified root. */
+    void build(size_t root);
+
+    /** Add a control flow edge and update the tree.
+     *
+     *  The tree must have been built already.  Returns true if any immediate dominator changed. */
+    bool insert_edge(size_t source, size_t target);
+
+    /** Root vertex specified for the last build(), or NO_VERTEX. */
+    size_t root() const { return root_; }
+
+    /** Immediate dominator of a vertex.
+     *
+     *  Returns NO_VERTEX for the root and for vertices that are not reachable from the root. */
+    size_t idom(size_t v) const { return idom_[v]; }
+
+    /** Immediate dominators of all vertices, indexed by vertex ID. */
+    const std::vector<size_t>& idoms() const { return idom_; }
+
+    /** True if the vertex is reachable from the root. */
+    bool is_reachable(size_t v) const { return v==root_ || idom_[v]!=NO_VERTEX; }
+
+    /** Depth of a reachable vertex in the dominator tree.  The root has depth zero. */
+    size_t depth(size_t v) const { return depth_[v]; }
+
+    /** Nearest common dominator of two reachable vertices. */
+    size_t nca(size_t a, size_t b) const;
+
+    /** True if @p a dominates @p b.  Dominance is reflexive. */
+    bool dominates(size_t a, size_t b) const;
+
+    /** Number of times the tree was computed from scratch, including calls to build(). */
+    size_t nbuilds() const { return nbuilds_; }
+
+private:
+    void compute();
+    void compute_depths(size_t first);
+
+private:
+    std::vector<std::vector<size_t> > succs_;           // successor vertices, indexed by vertex
+    std::vector<std::vector<size_t> > preds_;           // predecessor vertices, indexed by vertex
+    std::vector<size_t> idom_;                          // immediate dominators, indexed by vertex
+    std::vector<size_t> depth_;                         // depth in dominator tree, indexed by reachable vertex
+    std::vector<size_t> preorder_;                      // reachable vertices in DFS preorder; parents precede children
+    std::vector<size_t> prenum_;                        // position of each vertex in preorder_, or NO_VERTEX
+    std::vector<bool> visited_;                         // scratch for insert_edge, all false between calls
+    size_t root_;
+    size_t nbuilds_;
+};
+
 /** Class for calculating dominance on control flow graphs.
  *
  *  Block D "dominates" block I if every possible execution path from the function entry block to block I includes block
@@ -93,7 +191,15 @@ namespace BinaryAnalysis {
  */
 class Dominance {
 public:
-    Dominance(): debug(NULL) {}
+    /** Algorithm used to compute immediate dominators.
+     *
+     *  Both algorithms produce the same results.  See build_idom_relation_from_cfg(). */
+    enum Algorithm {
+        ITERATIVE,                      /**< Cooper, Harvey, and Kennedy's iterative data flow algorithm. */
+        SEMI_NCA                        /**< Near-linear SEMI-NCA algorithm via DominatorTree. */
+    };
+
+    Dominance(): debug(NULL), algorithm(SEMI_NCA) {}
 
     /** The default dominance graph type.
      *
@@ -237,11 +343,12 @@ public:
      *  in the CFG), the stored value is the null vertex.  See RelationMap for details.
      *
      *  This method is intended to be the lowest level implementation for finding dominators; all other methods are built
-     *  upon this one.  This method uses an algorithm based on "A Simple, Fast Dominance Algorithm" by Keith
-     *  D. Cooper, Timothy J. Harvey, and Ken Kennedy at Rice University, Houston, Texas.  It has been extended in various
-     *  ways to simplify it and make it slightly faster.  Although run-time complexity is higher than the Lengauer-Tarjan
-     *  algorithm, the algorithm is much simpler, and for CFGs typically encountered in practice is faster than
-     *  Lengauer-Tarjan.
+     *  upon this one.  The algorithm is chosen with set_algorithm().  The default, SEMI_NCA, builds a DominatorTree (see
+     *  build_dominator_tree()) and runs in near-linear time.  The ITERATIVE algorithm is based on "A Simple, Fast Dominance
+     *  Algorithm" by Keith D. Cooper, Timothy J. Harvey, and Ken Kennedy at Rice University, Houston, Texas, extended in
+     *  various ways to simplify it and make it slightly faster.  It is competitive on small CFGs but its run time grows
+     *  quadratically, which is noticeable on functions with many thousands of basic blocks.  Its debug trace is more
+     *  detailed.
      *
      *  @{ */
     template<class ControlFlowGraph>
@@ -296,6 +403,28 @@ public:
 
 
 
+    /** Builds a compact dominator tree.
+     *
+     *  Describes the control flow graph (CFG) to @p tree in terms of integer vertex descriptors and computes the immediate
+     *  dominator of every vertex reachable from @p start.  Nothing is written to the AST.  The tree can be updated
+     *  incrementally with DominatorTree::insert_edge() as control flow edges are discovered. */
+    template<class ControlFlowGraph>
+    void build_dominator_tree(const ControlFlowGraph &cfg,
+                              typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
+                              DominatorTree &tree/*out*/);
+
+    /** Builds a compact post dominator tree.
+     *
+     *  Like build_dominator_tree() except edges are reversed and the tree is rooted at the specified @p stop vertex, which is
+     *  normally the unique exit vertex of the function.  Unlike build_postdom_relation_from_cfg(), this method never
+     *  creates a temporary exit vertex; the caller should add one to the CFG if the function has more than one exit. */
+    template<class ControlFlowGraph>
+    void build_postdom_tree(const ControlFlowGraph &cfg,
+                            typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor stop,
+                            DominatorTree &tree/*out*/);
+
+
+
     /**********************************************************************************************************************
      *                                      Methods that build graphs
      **********************************************************************************************************************/
@@ -398,8 +527,22 @@ public:
      *  disabled. */
     FILE *get_debug() const { return debug; }
 
+    /** Property: algorithm for immediate dominators.
+     *
+     *  @{ */
+    void set_algorithm(Algorithm algorithm) { this->algorithm = algorithm; }
+    Algorithm get_algorithm() const { return algorithm; }
+    /** @} */
+
+protected:
+    template<class ControlFlowGraph>
+    void build_idom_relation_iterative(const ControlFlowGraph &cfg,
+                                       typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
+                                       RelationMap<ControlFlowGraph> &idom/*out*/);
+
 protected:
     FILE *debug;                    /**< Debugging stream, or null. */
+    Algorithm algorithm;            /**< Algorithm for immediate dominators. */
 };
 
 /******************************************************************************************************************************
@@ -491,6 +634,67 @@ Dominance::build_idom_relation_from_cfg(const ControlFlowGraph &cfg,
     return idom;
 }
 
+template<class ControlFlowGraph>
+void
+Dominance::build_idom_relation_from_cfg(const ControlFlowGraph &cfg,
+                                        typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
+                                        RelationMap<ControlFlowGraph> &result)
+{
+    typedef typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor CFG_Vertex;
+    if (ITERATIVE==algorithm) {
+        build_idom_relation_iterative(cfg, start, result);
+        return;
+    }
+
+    if (debug)
+        fprintf(debug, "rose::BinaryAnalysis::Dominance::build_idom_relation_from_cfg: starting at vertex %" PRIuPTR "\n", start);
+    DominatorTree tree;
+    build_dominator_tree(cfg, start, tree);
+    result.clear();
+    result.resize(num_vertices(cfg), boost::graph_traits<ControlFlowGraph>::null_vertex());
+    for (size_t i=0; i<tree.nvertices(); ++i) {
+        if (tree.idom(i)!=DominatorTree::NO_VERTEX)
+            result[i] = (CFG_Vertex)tree.idom(i);
+    }
+
+    if (debug) {
+        fprintf(debug, "  Final result:\n");
+        for (size_t i=0; i<result.size(); i++) {
+            if (result[i]==boost::graph_traits<ControlFlowGraph>::null_vertex()) {
+                fprintf(debug, "    CFG vertex %" PRIuPTR " has no immediate dominator\n", i);
+            } else {
+                fprintf(debug, "    CFG vertex %" PRIuPTR " has immediate dominator %" PRIuPTR "\n", i, (size_t)result[i]);
+            }
+        }
+    }
+}
+
+template<class ControlFlowGraph>
+void
+Dominance::build_dominator_tree(const ControlFlowGraph &cfg,
+                                typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
+                                DominatorTree &tree)
+{
+    tree.reset(num_vertices(cfg));
+    typename boost::graph_traits<ControlFlowGraph>::edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end)=edges(cfg); ei!=ei_end; ++ei)
+        tree.add_edge(source(*ei, cfg), target(*ei, cfg));
+    tree.build(start);
+}
+
+template<class ControlFlowGraph>
+void
+Dominance::build_postdom_tree(const ControlFlowGraph &cfg,
+                              typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor stop,
+                              DominatorTree &tree)
+{
+    tree.reset(num_vertices(cfg));
+    typename boost::graph_traits<ControlFlowGraph>::edge_iterator ei, ei_end;
+    for (boost::tie(ei, ei_end)=edges(cfg); ei!=ei_end; ++ei)
+        tree.add_edge(target(*ei, cfg), source(*ei, cfg));
+    tree.build(stop);
+}
+
 /* Loosely based on an algorithm from Rice University known to be O(n^2) where n is the number of vertices in the control flow
  * subgraph connected to the start vertex.  According to the Rice paper, their algorithm outperforms Lengauer-Tarjan on
  * typicall control flow graphs even though asymptotically, Lengauer-Tarjan is better.  The Rice algorithm is also much
@@ -525,9 +729,9 @@ Dominance::build_idom_relation_from_cfg(const ControlFlowGraph &cfg,
  */
 template<class ControlFlowGraph>
 void
-Dominance::build_idom_relation_from_cfg(const ControlFlowGraph &cfg,
-                                        typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
-                                        RelationMap<ControlFlowGraph> &result)
+Dominance::build_idom_relation_iterative(const ControlFlowGraph &cfg,
+                                         typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor start,
+                                         RelationMap<ControlFlowGraph> &result)
 {
     typedef typename boost::graph_traits<ControlFlowGraph>::vertex_descriptor CFG_Vertex;
 
@@ -1,8 +1,12 @@
 #ifndef ROSE_BinaryAnalysis_MagicNumber_H
 #define ROSE_BinaryAnalysis_MagicNumber_H
 
+#include <BinaryByteScanner.h>
 #include <MemoryMap.h>
 
+#include <string>
+#include <vector>
+
 namespace rose {
 namespace BinaryAnalysis {
 
@@ -61,6 +65,103 @@ private:
     void init();
 };
 
+/** Finds many file signatures at once.
+ *
+ *  Whereas @ref MagicNumber identifies the data at one address at a time, this class scans large areas of memory such as
+ *  firmware images for the locations of any of a set of byte signatures.  The signatures are compiled into an Aho-Corasick
+ *  automaton so that memory is scanned only once regardless of the number of signatures.  Bytes that cannot begin a
+ *  signature are skipped several at a time with @ref ByteScanner, and the automaton works directly on the buffers of the
+ *  memory map's segments.  Signatures that cross from one segment into an adjacent segment are found.
+ *
+ *  @code
+ *  MagicSignatures signatures = MagicSignatures::commonSignatures();
+ *  BOOST_FOREACH (const MagicSignatures::Match &match, signatures.scan(map.require(MemoryMap::READABLE)))
+ *      std::cout <<StringUtility::addrToString(match.va) <<" " <<signatures.signature(match.signatureId).name <<"\n";
+ *  @endcode */
+class MagicSignatures {
+public:
+    /** A byte signature. */
+    struct Signature {
+        std::string name;                               /**< Description, such as "gzip compressed data". */
+        std::string bytes;                              /**< Bytes to match; may contain NUL characters. */
+        size_t offset;                                  /**< Position of the bytes relative to the start of the data. */
+        Signature(const std::string &name, const std::string &bytes, size_t offset)
+            : name(name), bytes(bytes), offset(offset) {}
+    };
+
+    /** Location of a signature.
+     *
+     *  The address is the start of the identified data, which is the address where the signature's bytes were found minus
+     *  the signature's offset. */
+    struct Match {
+        rose_addr_t va;                                 /**< Starting address of the identified data. */
+        size_t signatureId;                             /**< Index of the matching signature. */
+        Match(rose_addr_t va, size_t signatureId): va(va), signatureId(signatureId) {}
+        bool operator==(const Match &other) const { return va == other.va && signatureId == other.signatureId; }
+        bool operator<(const Match &other) const {
+            return va < other.va || (va == other.va && signatureId < other.signatureId);
+        }
+    };
+
+private:
+    std::vector<Signature> signatures_;
+    ByteScanner::Implementation implementation_;
+
+    // The automaton is built lazily by compile().
+    mutable bool compiled_;
+    mutable std::vector<uint32_t> delta_;               // transitions, 256 per state; state zero is the start state
+    mutable std::vector<std::vector<size_t> > output_;  // signatures that end at each state, including via failure links
+    mutable ByteScanner::ByteSet firstBytes_;           // bytes that leave the start state
+
+public:
+    /** Construct an object with no signatures. */
+    MagicSignatures(): implementation_(ByteScanner::bestImplementation()), compiled_(false) {}
+
+    /** Signatures for data commonly embedded in firmware images.
+     *
+     *  Returns an object containing signatures for executable formats (ELF, PE, Mach-O, Java), archives and compressed data
+     *  (gzip, bzip2, xz, LZMA, zip, 7-zip, RAR, tar, cpio), file systems (SquashFS, CramFS, JFFS2, UBI), boot images
+     *  (U-Boot), and images (PNG, JPEG, GIF). */
+    static MagicSignatures commonSignatures();
+
+    /** Add a signature.
+     *
+     *  Returns the index of the new signature. The @p bytes must not be empty. */
+    size_t insert(const std::string &name, const std::string &bytes, size_t offset=0);
+
+    /** Number of signatures. */
+    size_t nSignatures() const { return signatures_.size(); }
+
+    /** Signature by index. */
+    const Signature& signature(size_t id) const { return signatures_[id]; }
+
+    /** Property: Scanning implementation.
+     *
+     *  The instruction set used to skip bytes that can't start a signature. All implementations give the same results.
+     *
+     * @{ */
+    ByteScanner::Implementation implementation() const { return implementation_; }
+    void implementation(ByteScanner::Implementation impl) { implementation_ = impl; }
+    /** @} */
+
+    /** Find all signatures in memory.
+     *
+     *  Returns the matches sorted by address.  Matches whose starting address would be below zero are discarded.  A signature
+     *  matches only if all its bytes satisfy the constraints and are at contiguous addresses.  Parts of memory that don't
+     *  satisfy the constraints (e.g., a segment that isn't readable) don't end the scan; it resumes after them. */
+    std::vector<Match> scan(MemoryMap::ConstConstraints where) const;
+
+    /** Find all signatures in a buffer.
+     *
+     *  The buffer is treated as if it were mapped at address @p va. Matches are appended to @p matches in the order their
+     *  last byte is found. */
+    void scan(rose_addr_t va, const uint8_t *data, size_t size, std::vector<Match> &matches /*in,out*/) const;
+
+private:
+    void compile() const;
+    friend struct SignatureScanner;
+};
+
 } // namespace
 } // namespace
 #endif
@@ -1,6 +1,7 @@
 #ifndef ROSE_BinaryAnalysis_String_H
 #define ROSE_BinaryAnalysis_String_H
 
+#include <BinaryByteScanner.h>
 #include <MemoryMap.h>
 #include <sawyer/Optional.h>
 
@@ -11,8 +12,13 @@ namespace BinaryAnalysis {
  *
  *  This analysis looks for various kinds of strings in specimen memory.  A string is a sequence of characters encoded in one
  *  of a variety of ways in memory.  For instance, NUL-terminated ASCII is a common encoding from C compilers.  The characters
- *  within the string must all satisfy some valid-character predicate. */
+ *  within the string must all satisfy some valid-character predicate.
+ *
+ *  Memory is scanned directly in the buffers of the memory map's segments using the vectorized loops of @ref ByteScanner,
+ *  so searching large specimens such as firmware images doesn't require copying their contents. */
 class StringFinder {
+    ByteScanner::Implementation implementation_;
+
 public:
     /** How string length is represented. */
     enum LengthEncoding {
@@ -102,12 +108,33 @@ public:
     typedef Sawyer::Container::Map<rose_addr_t, String> Strings;
 
 public:
+    /** Construct a string finder that uses the best available scanning implementation. */
+    StringFinder(): implementation_(ByteScanner::bestImplementation()) {}
+
+    virtual ~StringFinder() {}
+
+    /** Property: Scanning implementation.
+     *
+     *  The instruction set used to scan memory. All implementations give the same results; this is mostly useful for
+     *  comparing their speeds.
+     *
+     * @{ */
+    ByteScanner::Implementation implementation() const { return implementation_; }
+    void implementation(ByteScanner::Implementation impl) { implementation_ = impl; }
+    /** @} */
+
     /** Predicate determining valid ASCII character.
      *
      *  This predicate returns true if the specified byte is considered to be a valid character for an ASCII string.  The base
      *  implementation returns true for white space or characters having a graphic. */
     virtual bool isAsciiCharacter(uint8_t) const;
-    
+
+    /** Set of all valid ASCII characters.
+     *
+     *  Returns the set of bytes for which @ref isAsciiCharacter returns true. The scanning functions use this set rather than
+     *  calling the predicate for each byte, so subclasses that override the predicate need not do anything else. */
+    ByteScanner::ByteSet asciiCharacters() const;
+
     /** Find the starting address for the next sequence of ASCII characters.  If a sequence of at least @p minChars characters
      *  can be found in the memory map then return the address for the starting character, otherwise return nothing.
      *
@@ -152,7 +179,12 @@ public:
     Sawyer::Optional<String> findString(MemoryMap::ConstConstraints where) const;
     /** @} */
 
-    /** Find all strings in memory. */
+    /** Find all strings in memory.
+     *
+     *  Scans memory once and returns the strings that @ref findString would return if it were called repeatedly, each call
+     *  starting where the previous string ended.  Unlike @ref findString, which stops searching at the first part of memory
+     *  that doesn't satisfy the constraints (e.g., a segment that isn't readable), this method skips such parts and resumes
+     *  after them.  A string never spans a skipped part. */
     Strings findAllStrings(MemoryMap::ConstConstraints where) const;
 
     /** Read a string from memory. */
@@ -3,6 +3,9 @@
 
 #include "sqlite3x.h"
 
+// Memory-mapped alternative to the sqlite database for large signature sets.
+#include "signatureIndex.h"
+
 // #include "functionIdentification.h"
 // #include "rose.h"
 // #include "libraryIdentification.h"
@@ -0,0 +1,120 @@
+#ifndef LIBRARY_IDENTIFICATION_SIGNATURE_INDEX_H
+#define LIBRARY_IDENTIFICATION_SIGNATURE_INDEX_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// #include "libraryIdentification.h"
+
+namespace LibraryIdentification
+   {
+  // The signature index is the alternative to the sqlite database (FunctionIdentification) for large
+  // signature sets (e.g. libc, openssl, boost).  It is a single file with two open-addressing hash tables
+  // that is memory-mapped read-only, so opening it costs nothing regardless of its size and lookups
+  // neither parse SQL nor copy data.  Lookups are const and can be issued from several threads at once.
+  //
+  // Each function is represented by:
+  //    1) a key for exact matches: the first 8 bytes of the MD5 sum of the opcode vector (the same
+  //       MD5 sum that is saved in the sqlite databases, so existing databases can be imported), and
+  //    2) a sketch for near matches: the smallest (bottom-k) hashes of the n-grams of the opcode vector
+  //       (immediates are already zeroed by FlattenAST_AndResetImmediateValues).  The fraction of
+  //       shared sketch hashes estimates the similarity of two functions (MinHash).
+  //
+  // Database files ending in ".sigidx" are handled with the signature index by
+  // generateLibraryIdentificationDataBase() and matchAgainstLibraryIdentificationDataBase().
+
+     class library_handle;
+
+  // Returns true if the named database is a signature index (name ends in ".sigidx").
+     bool isSignatureIndexName( const std::string & databaseName );
+
+  // Exact match key of an opcode vector, and of an MD5 sum (or raw opcode vector if MD5 support
+  // is not available) as saved in the sqlite databases.
+     uint64_t signatureKey( const unsigned char* str, size_t str_length );
+     uint64_t signatureKeyFromDatabaseEntry( const unsigned char* md5_sum, size_t length );
+
+  // Bottom-k n-gram hashes of an opcode vector, sorted (empty for vectors shorter than an n-gram).
+     std::vector<uint64_t> signatureSketch( const unsigned char* str, size_t str_length );
+
+     class SignatureIndexBuilder
+        {
+          public:
+               SignatureIndexBuilder() {}
+
+            // Add a function from its opcode vector.
+               void add( const library_handle & handle, const std::vector<unsigned char> & opcode_vector );
+
+            // Add a function for which only the exact match key is known (imported entries).
+               void add( const library_handle & handle, uint64_t key );
+
+            // Add all functions of a sqlite database written by FunctionIdentification, returns the
+            // number of imported functions.  Imported functions only match exactly, since the sqlite
+            // databases store no n-grams.
+               size_t importSqliteDatabase( const std::string & databaseName );
+
+            // Write the index file (overwrites an existing file).
+               void write( const std::string & fileName ) const;
+
+               size_t size() const { return entries.size(); }
+
+          private:
+               struct Entry
+                  {
+                    std::string filename;
+                    std::string function_name;
+                    size_t begin;
+                    size_t end;
+                    uint64_t key;
+                    std::vector<uint64_t> sketch;
+                  };
+
+               std::vector<Entry> entries;
+        };
+
+     class SignatureIndex
+        {
+          public:
+            // Maps the index file; throws std::runtime_error if it can not be read.
+               SignatureIndex( const std::string & fileName );
+              ~SignatureIndex();
+
+            // Return the library_handle of the function matching the opcode vector.  The exact key
+            // is tried first, then the sketch.  bool false is returned if there is no (unique) match.
+            // As with the sqlite database, an opcode vector that was saved more than once is not
+            // matched, and the sketch is not tried for it either.
+               bool get_function_match( library_handle & handle, const std::vector<unsigned char> & opcode_vector ) const;
+
+               size_t size() const;
+
+               struct Header;
+               struct Record;
+               struct Slot;
+
+          private:
+               enum MatchResult { NO_MATCH, UNIQUE_MATCH, AMBIGUOUS_MATCH };
+
+               MatchResult exact_match ( uint64_t key, size_t & record ) const;
+               bool        sketch_match( const std::vector<uint64_t> & sketch, size_t & record ) const;
+               void        fill_handle ( library_handle & handle, size_t record ) const;
+
+               std::string    file_name;
+               void*          mapping;
+               size_t         mapping_size;
+
+               const Header*  header;
+               const Record*  records;
+               const Slot*    exact_slots;
+               const Slot*    ngram_slots;
+               const char*    strings;
+
+            // Not copyable (owns the mapping).
+               SignatureIndex( const SignatureIndex & );
+               SignatureIndex & operator=( const SignatureIndex & );
+        };
+
+  // Convert a sqlite database written by generateLibraryIdentificationDataBase() into a signature index.
+     void importLibraryIdentificationDataBase( std::string sqliteDatabaseName, std::string indexName );
+   }
+
+#endif
@@ -1,11 +1,13 @@
 #ifndef ROSE_EditDistance_TreeEditDistance_H
-#define ROSE_EditDistnace_TreeEditDistance_H
+#define ROSE_EditDistance_TreeEditDistance_H
 
 #include "Diagnostics.h"
 
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/graph_traits.hpp>
 
+#include <cstddef>
+#include <limits>
 #include <map>
 #include <string>
 #include <vector>
@@ -41,7 +43,24 @@ namespace EditDistance {                                // documented elsewhere
  * @endcode
  *
  *  The analysis object can be reused as many times as one likes by calling its @c compute method with different trees. The
- *  query methods always return the same results until the next call to @c compute. */
+ *  query methods always return the same results until the next call to @c compute.
+ *
+ *  When only similar trees are of interest, a cost limit makes the analysis much faster for large trees, and many trees can
+ *  be compared with one another in parallel:
+ *
+ * @code
+ *  std::vector<SgNode*> functions = ...;
+ *  TreeEditDistance::CostMatrix costs = TreeEditDistance::Analysis()
+ *                                           .substitutionCost(0.0)
+ *                                           .costLimit(10.0)
+ *                                           .computeAllPairs(functions, 8);
+ *  for (size_t i=0; i<costs.size(); ++i) {
+ *      for (size_t j=0; j<costs.size(); ++j) {
+ *          if (i!=j && !costs.exceedsCostLimit(i, j))
+ *              std::cout <<i <<" and " <<j <<" differ by " <<costs(i, j) <<"\n";
+ *      }
+ *  }
+ * @endcode */
 namespace TreeEditDistance {
 
 // Any header that #defines words that are this common is just plain stupid!
@@ -88,6 +107,43 @@ public:
     virtual bool operator()(SgNode *source, SgNode *target) = 0;
 };
 
+/** Edit costs for all pairs of a list of trees.
+ *
+ *  This is the result of @ref Analysis::computeAllPairs.  The entry at (@p source, @p target) is the cost of editing tree
+ *  number @p source to make it the same shape as tree number @p target.  Entries whose cost exceeds the analysis' cost limit
+ *  are infinity. */
+class CostMatrix {
+    size_t n_;
+    std::vector<double> costs_;
+public:
+    /** Construct an empty matrix. */
+    CostMatrix(): n_(0) {}
+
+    /** Construct an @p n by @p n matrix of zeros. */
+    explicit CostMatrix(size_t n): n_(n), costs_(n*n, 0.0) {}
+
+    /** Number of trees (rows and columns). */
+    size_t size() const { return n_; }
+
+    /** Cost of editing one tree into another.
+     *
+     * @{ */
+    double operator()(size_t source, size_t target) const {
+        ASSERT_require(source < n_ && target < n_);
+        return costs_[source*n_ + target];
+    }
+    double& operator()(size_t source, size_t target) {
+        ASSERT_require(source < n_ && target < n_);
+        return costs_[source*n_ + target];
+    }
+    /** @} */
+
+    /** True if the cost of editing one tree into another exceeded the cost limit. */
+    bool exceedsCostLimit(size_t source, size_t target) const {
+        return (*this)(source, target) == std::numeric_limits<double>::infinity();
+    }
+};
+
 /** Analysis object for tree edit distance.
  *
  *  The Analysis object holds the settings and state for performing tree edit distance. See @ref TreeEditDistance for details
@@ -116,11 +172,19 @@ class Analysis {
     std::vector<Vertex> predecessors_;                  // predecessor vertex for each node in minimal-cost path from origin
     SubstitutionPredicate *substitutionPredicate_;      // determines whether one node can be substituted for another
 
+    // Results when a cost limit is used. The edit graph is not built; instead the edit path is recorded for the diagonal band
+    // of the (n1+1) x (n2+1) matrix that could lead to a cost within the limit.
+    double costLimit_;                                  // maximum interesting cost, or negative for no limit
+    double limitedCost_;                                // cost computed with a limit, infinity if exceeded
+    ptrdiff_t bandHi_;                                  // largest row-column difference in the band
+    size_t bandWidth_;                                  // number of diagonals in the band
+    std::vector<unsigned char> bandMoves_;              // edit that reaches each band cell, row-major by band position
+
 public:
     /** Construct an analysis with default values. */
     Analysis()
         : insertionCost_(1.0), deletionCost_(1.0), substitutionCost_(1.0), ast1_(NULL), ast2_(NULL),
-          substitutionPredicate_(NULL)  {}
+          substitutionPredicate_(NULL), costLimit_(-1.0), limitedCost_(0.0), bandHi_(0), bandWidth_(0) {}
 
     /** Forget calculated results.
      *
@@ -132,6 +196,9 @@ public:
         depths1_.clear(), depths2_.clear();
         graph_ = Graph();
         totalCost_.clear(), predecessors_.clear();
+        limitedCost_ = 0.0;
+        bandHi_ = 0, bandWidth_ = 0;
+        bandMoves_.clear();
         return *this;
     }
     
@@ -196,6 +263,25 @@ public:
     }
     /** @} */
 
+    /** Property: cost limit.
+     *
+     *  When the cost limit is non-negative, @ref compute gives up as soon as it can prove that the edit cost is larger than
+     *  the limit, in which case @ref cost returns infinity and @ref exceedsCostLimit returns true.  Instead of building the
+     *  full graph, the analysis then uses dynamic programming over the band of the edit matrix that can lead to a cost within
+     *  the limit: a path through row @em i and column @em j needs at least <em>|i-j|</em> insertions or deletions to get
+     *  there and <em>|(n1-i)-(n2-j)|</em> to get to the end.  Trees whose @ref costLowerBound exceeds the limit are
+     *  rejected without looking at the matrix at all.  The default is a negative value, meaning there is no limit.
+     *
+     * @{ */
+    double costLimit() const {
+        return costLimit_;
+    }
+    Analysis& costLimit(double limit) {
+        costLimit_ = limit;
+        return *this;
+    }
+    /** @} */
+
     /** Compute tree edit distances.
      *
      *  Computes edit distances and stores them in this analysis.  Most of the other methods simply query the results computed
@@ -234,6 +320,25 @@ public:
     Analysis& compute();
     /** @} */
 
+    /** Compute edit costs for all pairs of trees.
+     *
+     *  Returns a matrix whose entry (@em i, @em j) is the cost of editing @p trees[i] to make it the same shape as @p
+     *  trees[j], using the costs, substitution predicate, and cost limit of this analysis.  Each tree is traversed only
+     *  once, and the comparisons are distributed over @p nThreads threads (the calling thread is one of them), so the
+     *  substitution predicate, if any, must be thread safe.  The results of this analysis object (@ref cost, etc.) are not
+     *  changed. */
+    CostMatrix computeAllPairs(const std::vector<SgNode*> &trees, size_t nThreads=1) const;
+
+    /** Lower bound for the cost of the current trees.
+     *
+     *  Every node of the source tree is either deleted or substituted by a target node at the same depth, and every node of
+     *  the target tree is either inserted or substitutes a source node.  Counting the nodes at each depth therefore gives a
+     *  lower bound for the edit cost that is computed in linear time. */
+    double costLowerBound() const;
+
+    /** True if the last @ref compute gave up because the cost exceeded the cost limit. */
+    bool exceedsCostLimit() const;
+
     /** Total cost for making one tree the same shape as the other.
      *
      *  This is the same value returned by the previous call to @ref compute and also available by querying for the actual list
@@ -268,7 +373,7 @@ public:
     /** Number of vertices and edges in the graph.
      *
      *  The graph is used to compute Dijkstra's shortest path and minimize the cost of the edits.  This function returns the
-     *  number of vertices and edges in the graph. */
+     *  number of vertices and edges in the graph, which are both zero when a @ref costLimit is used. */
     std::pair<size_t, size_t> graphSize() const;
 
     /** Emit a GraphViz file.
@@ -281,7 +386,9 @@ public:
      *  that was computed by the @ref compute method.
      *
      *  The output file also contains invisible edges in an attempt to coerce "dot" into making a layout that is as close to
-     *  being a matrix as possible. */
+     *  being a matrix as possible.
+     *
+     *  The graph is not built when a @ref costLimit is used, in which case the output is an empty graph. */
     void emitGraphViz(std::ostream&) const;
 
     /** Change one tree or the other.
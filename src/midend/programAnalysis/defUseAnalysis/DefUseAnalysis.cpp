@@ -11,6 +11,8 @@
 #include "GlobalVarAnalysis.h"
 #include <boost/config.hpp>
 #include <boost/bind.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
 
 
 using namespace std;
@@ -39,6 +41,12 @@ int DefUseAnalysis::getIntForSgNode(SgNode* sgNode) {
 bool DefUseAnalysis::addID(SgNode* sgNode) { 
   //  if (visualizationEnabled) {
   if (searchVizzMap(sgNode)==false) {
+    if (deferIDs) {
+      // numbered later, in this order, by the thread that merges the tables
+      vizzhelp[sgNode] = -1;
+      deferredIDs.push_back(sgNode);
+      return true;
+    }
 #if ROSE_GCC_OMP
 #pragma omp critical (DefUseAnalysisaddID) 
 #endif
@@ -263,11 +271,17 @@ void DefUseAnalysis::printUseMap() {
 void DefUseAnalysis::printAnyMap(tabletype* tabl) {
   int pos = 0;
   cout << "\n **************** MAP ************************** " << endl;
-  for (tabletype::const_iterator i = tabl->begin(); i != tabl->end(); ++i) {  
+  // the table is hashed; print in key order, as when it was a std::map
+  std::vector<SgNode*> keys;
+  keys.reserve(tabl->size());
+  for (tabletype::const_iterator i = tabl->begin(); i != tabl->end(); ++i)
+    keys.push_back(i->first);
+  std::sort(keys.begin(), keys.end());
+  for (std::vector<SgNode*>::const_iterator i = keys.begin(); i != keys.end(); ++i) {
     pos++;
-    SgNode* sgNode = (*i).first;
+    SgNode* sgNode = *i;
     ROSE_ASSERT(sgNode);
-    multitype multi = (*i).second;
+    const multitype& multi = (*tabl)[sgNode];
     string name = getInitName(sgNode);
     int theNode = getIntForSgNode(sgNode);
     cout << pos << ": " << ToString(theNode) << " var: " << name << endl;
@@ -328,7 +342,7 @@ bool DefUseAnalysis::searchVizzMap(SgNode* node) {
 /**********************************************************
  *  Search for the value for a certain key in the map
  *********************************************************/
-bool DefUseAnalysis::searchMap(const tabletype* ltable, SgNode* node) {
+bool DefUseAnalysis::searchMap(const tabletype* ltable, SgNode* node) const {
   bool isCurrentValueContained=false;
   //  std::cerr << " size map : " << ltable->size() << std::endl;
 #if 0   
@@ -358,8 +372,10 @@ bool DefUseAnalysis::searchMap(const tabletype* ltable, SgNode* node) {
  * for any given node and initName, return all definitions 
  *****************************************/
 std::vector < SgNode* > DefUseAnalysis::getDefFor(SgNode* node, SgInitializedName* initName) {
-  multitype multi = getDefMultiMapFor(node);
-  return getAnyFor( &multi, initName); 
+  const multitype* multi = findDefsFor(node);
+  if (multi==NULL)
+    return std::vector < SgNode* >();
+  return getAnyFor(multi, initName); 
 }
 
 /******************************************
@@ -367,8 +383,10 @@ std::vector < SgNode* > DefUseAnalysis::getDefFor(SgNode* node, SgInitializedNam
  * for any given node and initName, return all definitions 
  *****************************************/
 std::vector < SgNode* > DefUseAnalysis::getUseFor(SgNode* node, SgInitializedName* initName) {
-  multitype multi = getUseMultiMapFor(node);
-  return getAnyFor(&multi, initName); 
+  const multitype* multi = findUsesFor(node);
+  if (multi==NULL)
+    return std::vector < SgNode* >();
+  return getAnyFor(multi, initName); 
 }
 
 /******************************************
@@ -398,12 +416,8 @@ std::vector < SgNode* > DefUseAnalysis::getAnyFor(const multitype* multi, SgInit
  * for any given node, return all definitions 
  *****************************************/
 std::vector <std::pair < SgInitializedName* , SgNode*> > DefUseAnalysis::getDefMultiMapFor(SgNode* node) {
-  multitype multi;
-  if (searchMap(&table, node)==true) {
-    // multimap is contained
-    multi = table[node];
-  }
-  return multi;
+  const multitype* multi = findDefsFor(node);
+  return multi ? *multi : multitype();
 }
 
 /******************************************
@@ -411,12 +425,26 @@ std::vector <std::pair < SgInitializedName* , SgNode*> > DefUseAnalysis::getDefM
  * for any given node, return all definitions 
  *****************************************/
 std::vector <std::pair < SgInitializedName* , SgNode*> > DefUseAnalysis::getUseMultiMapFor(SgNode* node) {
-  multitype multi;
-  if (searchMap(&usetable, node)==true) {
-    // multimap is contained
-    multi = usetable[node];
-  }
-  return multi;
+  const multitype* multi = findUsesFor(node);
+  return multi ? *multi : multitype();
+}
+
+/******************************************
+ * return the definitions of a node without copying
+ * NULL if the node is not in the table
+ *****************************************/
+const DefUseAnalysis::multitype* DefUseAnalysis::findDefsFor(SgNode* node) const {
+  tabletype::const_iterator i = table.find(node);
+  return i==table.end() ? NULL : &i->second;
+}
+
+/******************************************
+ * return the usages of a node without copying
+ * NULL if the node is not in the table
+ *****************************************/
+const DefUseAnalysis::multitype* DefUseAnalysis::findUsesFor(SgNode* node) const {
+  tabletype::const_iterator i = usetable.find(node);
+  return i==usetable.end() ? NULL : &i->second;
 }
 
 /******************************************
@@ -490,6 +518,142 @@ bool  DefUseAnalysis::start_traversal_of_functions() {
   return abortme;  
 }
 
+/******************************************
+ * Parallel traversal over all functions
+ * Every function is analyzed by a private copy of this analysis that
+ * only holds the global variables. The copies are merged afterwards
+ * in the same order as start_traversal_of_functions visits them, so
+ * that node numbers and the DOT output match the serial run.
+ *****************************************/
+namespace {
+  // the result of analyzing one function
+  struct DefUseFunctionResult {
+    DefUseAnalysis::tabletype defs;
+    DefUseAnalysis::tabletype uses;
+    std::vector<SgNode*> ids;
+    std::vector <FilteredCFGNode < IsDFAFilter > > source;
+    int nodesVisited;
+    bool aborted;
+    DefUseFunctionResult(): nodesVisited(0), aborted(false) {}
+  };
+
+  // shared between all worker threads
+  struct DefUseJob {
+    const DefUseAnalysis& seed;
+    const std::vector<SgFunctionDefinition*>& functions;
+    std::vector<DefUseFunctionResult>& results;
+    boost::mutex mutex;                 // protects next
+    size_t next;
+    DefUseJob(const DefUseAnalysis& seed, const std::vector<SgFunctionDefinition*>& functions,
+              std::vector<DefUseFunctionResult>& results)
+      : seed(seed), functions(functions), results(results), next(0) {}
+  };
+
+  struct DefUseWorker {
+    DefUseJob& job;
+    DefUseWorker(DefUseJob& job): job(job) {}
+    void operator()();
+  };
+}
+
+void DefUseWorker::operator()() {
+  while (true) {
+    size_t idx;
+    {
+      boost::lock_guard<boost::mutex> lock(job.mutex);
+      if (job.next >= job.functions.size())
+        return;
+      idx = job.next++;
+    }
+    DefUseFunctionResult& result = job.results[idx];
+    DefUseAnalysis local(job.seed);
+    local.analyzeFunctionDeferred(job.functions[idx], result.defs, result.uses, result.ids, result.source,
+                                  result.nodesVisited, result.aborted);
+  }
+}
+
+void
+DefUseAnalysis::analyzeFunctionDeferred(SgFunctionDefinition* proc, tabletype& defs, tabletype& uses,
+                                        std::vector<SgNode*>& ids, std::vector <FilteredCFGNode < IsDFAFilter > >& source,
+                                        int& nodesVisited, bool& aborted) {
+  deferIDs = true;
+  deferredIDs.clear();
+  DefUseAnalysisPF defuse_perfunc(false, this);
+  FilteredCFGNode <IsDFAFilter> rem_source = defuse_perfunc.run(proc, aborted);
+  nodesVisited = defuse_perfunc.getNumberOfNodesVisited();
+  if (rem_source.getNode()!=NULL)
+    source.push_back(rem_source);
+  defs.swap(table);
+  uses.swap(usetable);
+  ids.swap(deferredIDs);
+}
+
+/******************************************
+ * Merge the table of one function into this table.
+ * Nodes that belong to the function are simply added, the entries
+ * of global variables are the union over all functions.
+ *****************************************/
+static void mergeDefUseTable(DefUseAnalysis::tabletype& into, DefUseAnalysis::tabletype& from) {
+  for (DefUseAnalysis::tabletype::iterator i = from.begin(); i != from.end(); ++i) {
+    std::pair<DefUseAnalysis::tabletype::iterator, bool> inserted =
+      into.insert(std::make_pair(i->first, DefUseAnalysis::multitype()));
+    DefUseAnalysis::multitype& multi = inserted.first->second;
+    if (inserted.second) {
+      multi.swap(i->second);
+    } else {
+      for (DefUseAnalysis::multitype::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
+        if (std::find(multi.begin(), multi.end(), *j) == multi.end())
+          multi.push_back(*j);
+      }
+    }
+  }
+  from.clear();
+}
+
+bool DefUseAnalysis::start_parallel_traversal_of_functions(size_t nthreads) {
+  if (DEBUG_MODE) 
+    cout << "START: Parallel traversal over Functions (" << nthreads << " threads)" << endl;
+
+  nrOfNodesVisited = 0;
+  dfaFunctions.clear();
+
+  std::vector<SgFunctionDefinition*> functions;
+  Rose_STL_Container<SgNode*> nodes = NodeQuery::querySubTree(project, V_SgFunctionDefinition); 
+  for (Rose_STL_Container<SgNode*>::const_iterator i = nodes.begin(); i != nodes.end(); ++i)
+    functions.push_back(isSgFunctionDefinition(*i));
+
+  std::vector<DefUseFunctionResult> results(functions.size());
+  DefUseJob job(*this, functions, results);
+
+  size_t nworkers = std::max(nthreads, (size_t)1) - 1;
+  boost::thread *workers = new boost::thread[nworkers];
+  for (size_t i=0; i<nworkers; ++i)
+    workers[i] = boost::thread(DefUseWorker(job));
+  DefUseWorker self(job);               // participate in the work ourselves
+  self();
+  for (size_t i=0; i<nworkers; ++i)
+    workers[i].join();
+  delete[] workers;
+
+  bool abortme = false;
+  for (size_t i=0; i<results.size(); ++i) {
+    DefUseFunctionResult& result = results[i];
+    for (std::vector<SgNode*>::const_iterator j = result.ids.begin(); j != result.ids.end(); ++j)
+      addID(*j);
+    mergeDefUseTable(table, result.defs);
+    mergeDefUseTable(usetable, result.uses);
+    nrOfNodesVisited += result.nodesVisited;
+    dfaFunctions.insert(dfaFunctions.end(), result.source.begin(), result.source.end());
+    abortme = abortme || result.aborted;
+  }
+
+  if (DEBUG_MODE) {
+    dfaToDOT();
+    cout << "FINISH: Parallel traversal over Functions" << endl;
+  }
+  return abortme;
+}
+
 /******************************************
  * Traversal over one function
  *****************************************/
@@ -517,6 +681,26 @@ int DefUseAnalysis::run(bool debug) {
   return run();
 }
 
+/******************************************
+ * Same as run(), but the functions are
+ * analyzed concurrently
+ ******************************************/
+int DefUseAnalysis::runParallel(size_t nthreads) {
+  sgNodeCounter = 1;
+  nrOfNodesVisited = 0;
+  ROSE_ASSERT(project != NULL);
+
+  table.clear();
+  usetable.clear();
+  vizzhelp.clear();
+
+  find_all_global_variables();
+  bool aborted = start_parallel_traversal_of_functions(nthreads);
+  if (DEBUG_MODE)
+    cout << ">>>>> Total CFG nodes: " << getDefSize() << "  --  #CFG nodes visited: "<< nrOfNodesVisited << endl;
+  return aborted ? 1 : 0;
+}
+
 /******************************************
  * This algo consists of two parts: 
  * a) locate all global variables and add them to the def-use table  
@@ -65,11 +65,16 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
 
   bool visualizationEnabled;
 
+ public:
   // def-use-specific --------------------
   typedef std::vector < std::pair<SgInitializedName* , SgNode*> > multitype;
   //  typedef std::multimap < SgInitializedName* , SgNode* > multitype;
 
-  typedef std::map< SgNode* , multitype > tabletype;
+  // the tables are hashed on the node; use getDefMap()/getUseMap() if an ordered copy is needed
+  typedef rose_hash::unordered_map< SgNode* , multitype > tabletype;
+  typedef tabletype::const_iterator const_iterator;
+
+ private:
   // typedef std::map< SgNode* , int > convtype;
 // CH (4/9/2010): Use boost::unordered instead  
 //#ifdef _MSC_VER
@@ -83,7 +88,8 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   // local functions ---------------------
   void find_all_global_variables();
   bool start_traversal_of_functions();
-  bool searchMap(const tabletype* ltable, SgNode* node);
+  bool searchMap(const tabletype* ltable, SgNode* node) const;
+  bool start_parallel_traversal_of_functions(size_t nthreads);
   bool searchVizzMap(SgNode* node);
   std::string getInitName(SgNode* sgNode);
 
@@ -100,6 +106,10 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   // functions to be printed in DFAtoDOT
   std::vector <FilteredCFGNode < IsDFAFilter > > dfaFunctions;
 
+  // when set, addID records nodes in deferredIDs instead of numbering them (see runParallel)
+  bool deferIDs;
+  std::vector<SgNode*> deferredIDs;
+
   void addAnyElement(tabletype* tabl, SgNode* sgNode, SgInitializedName* initName, SgNode* defNode);
   void mapAnyUnion(tabletype* tabl, SgNode* before, SgNode* other, SgNode* current);
   void printAnyMap(tabletype* tabl);
@@ -107,7 +117,8 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
 
  public:
   DefUseAnalysis(SgProject* proj): project(proj), 
-    DEBUG_MODE(false), DEBUG_MODE_EXTRA(false){
+    DEBUG_MODE(false), DEBUG_MODE_EXTRA(false), visualizationEnabled(true),
+    nrOfNodesVisited(0), deferIDs(false) {
     //visualizationEnabled=true;
     //table.clear();
     //usetable.clear();
@@ -117,17 +128,39 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   };
   virtual ~DefUseAnalysis() {}
 
-  std::map< SgNode* , multitype  > getDefMap() { return table;}
-  std::map< SgNode* , multitype  > getUseMap() { return usetable;}
+  /** Ordered copies of the def and use tables.  These copy every entry; clients that only read the tables should use
+   *  getDefTable()/getUseTable() or the iterators below instead. */
+  std::map< SgNode* , multitype  > getDefMap() { return std::map< SgNode* , multitype >(table.begin(), table.end());}
+  std::map< SgNode* , multitype  > getUseMap() { return std::map< SgNode* , multitype >(usetable.begin(), usetable.end());}
   void setMaps(std::map< SgNode* , multitype  > def,
           std::map< SgNode* , multitype > use) {
-    table = def;
-    usetable = use;
+    table = tabletype(def.begin(), def.end());
+    usetable = tabletype(use.begin(), use.end());
   }
+
+  /** Read-only access to the def and use tables without copying them. */
+  const tabletype& getDefTable() const { return table; }
+  const tabletype& getUseTable() const { return usetable; }
+
+  /** Iterate over the (node, multitype) entries of the def and use tables. */
+  const_iterator def_begin() const { return table.begin(); }
+  const_iterator def_end() const { return table.end(); }
+  const_iterator use_begin() const { return usetable.begin(); }
+  const_iterator use_end() const { return usetable.end(); }
+
+  /** Definitions (uses) reaching a node, or NULL if the node has no entry.  Unlike getDefMultiMapFor() and
+   *  getUseMultiMapFor() the result is not copied; it is valid until the tables are next modified. */
+  const multitype* findDefsFor(SgNode* node) const;
+  const multitype* findUsesFor(SgNode* node) const;
        
   // def-use-public-functions -----------
   int run();
   int run(bool debug);
+  /** Like run(), but analyzes the functions on @p nthreads threads. Each function is analyzed against its own copy of the
+   *  global variable definitions and the per-function tables are merged in the order run() would visit the functions.
+   *  Since functions do not see each other's definitions of global variables, entries involving globals may differ from
+   *  those computed by run(); all other entries are identical. */
+  int runParallel(size_t nthreads);
   multitype getDefMultiMapFor(SgNode* node);
   multitype  getUseMultiMapFor(SgNode* node);
   std::vector < SgNode* > getAnyFor(const multitype* mul, SgInitializedName* initName);
@@ -137,6 +170,10 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   std::vector <SgInitializedName*> getGlobalVariables();
   // the following one is used for parallel traversal
   int start_traversal_of_one_function(SgFunctionDefinition* proc);
+  // used by runParallel: analyze one function and move its tables, node numbering order and CFG source out
+  void analyzeFunctionDeferred(SgFunctionDefinition* proc, tabletype& defs, tabletype& uses,
+                               std::vector<SgNode*>& ids, std::vector <FilteredCFGNode < IsDFAFilter > >& source,
+                               int& nodesVisited, bool& aborted);
 
   // helpers -----------------------------
   bool searchMap(SgNode* node);
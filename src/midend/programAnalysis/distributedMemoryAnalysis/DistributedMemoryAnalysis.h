@@ -5,23 +5,59 @@
 #ifndef DISTRIBUTED_MEMORY_ANALYSIS_H
 #define DISTRIBUTED_MEMORY_ANALYSIS_H
 
-#if ROSE_MPI
-
 //#include <mpi.h>
 
 #include <utility>
+#include <vector>
+
+// When ROSE is configured with MPI the function-level traversals are split across MPI ranks. Otherwise the same interface
+// is implemented by a local backend that forks one worker process per "rank" on the current machine and collects the
+// serialized attributes through pipes (see DistributedMemoryLocalProcesses below).
 
 void initializeDistributedMemoryProcessing(int *argc, char ***argv);
 void finalizeDistributedMemoryProcessing();
 
+#if !ROSE_MPI
+// Non-template support for the local (fork-based) backend.
+namespace DistributedMemoryLocalProcesses
+{
+ // Number of worker processes. Defaults to the number of online processors; initializeDistributedMemoryProcessing()
+ // also accepts and removes a "--processes=N" command-line switch.
+    int numberOfProcesses();
+    void setNumberOfProcesses(int n);
+
+ // The work done by the worker processes.  The traversal implements this on top of analyzeSubtree() and
+ // serializeAttribute().
+    class Job
+    {
+    public:
+        virtual ~Job() {}
+     // Called once in each worker right after the fork.
+        virtual void enterProcess(int rank) = 0;
+        virtual std::pair<int, void *> analyzeFunction(size_t function) = 0;
+        virtual void deleteSerializedResult(std::pair<int, void *> serialized) = 0;
+    };
+
+ // Runs the job for every function in the worker process given by functionToProcess and returns the serialized result
+ // of each function, indexed like functionToProcess. Functions whose worker failed are re-analyzed in the calling
+ // process, so every entry of results is filled in.
+    void run(Job &job, const std::vector<int> &functionToProcess, std::vector<std::vector<unsigned char> > &results);
+}
+#endif
+
 template <class InheritedAttributeType>
 class DistributedMemoryAnalysisBase
 {
 public:
   bool isRootProcess() const {return (my_rank == root_process);}
   DistributedMemoryAnalysisBase() {
+#if ROSE_MPI
     MPI_Comm_rank(MPI_COMM_WORLD, &my_rank);
     MPI_Comm_size(MPI_COMM_WORLD, &processes);
+#else
+    my_rank = root_process;
+    processes = DistributedMemoryLocalProcesses::numberOfProcesses();
+#endif
     nrOfNodes=0;
   }
   virtual ~DistributedMemoryAnalysisBase() {}
@@ -46,6 +82,15 @@ public:
                                      AstTopDownProcessing<InheritedAttributeType> *preTraversal);
   void sortFunctions(std::vector<SgFunctionDeclaration*>& funcDecls, std::vector<InheritedAttributeType>& inhertiedValues,
                      std::vector<size_t>& nodeCounts, std::vector<size_t>& funcWeights);
+  // Like computeFunctionIndicesPerNode, but keeps funcDecls in traversal order: the most expensive functions are
+  // assigned first, each to the process with the least work so far.
+  void computeFunctionAssignment(SgNode *root, std::vector<int>& functionToProcessor,
+                                 InheritedAttributeType rootInheritedValue,
+                                 AstTopDownProcessing<InheritedAttributeType> *preTraversal);
+
+ protected:
+  // Used by the local backend, whose worker processes are forked from the root process.
+  void setMyID(int rank) { my_rank = rank; }
   
  private:
   int my_rank;
@@ -77,6 +122,10 @@ private:
     SynthesizedAttributeType finalResults;
     std::vector<SynthesizedAttributeType> functionResults;
 
+#if !ROSE_MPI
+    class LocalJob;
+#endif
+
     DistributedMemoryTraversal(const DistributedMemoryTraversal &);
     const DistributedMemoryTraversal &operator=(const DistributedMemoryTraversal &);
 };
@@ -174,5 +223,3 @@ private:
 #include "DistributedMemoryAnalysisImplementation.h"
 
 #endif
-
-#endif
@@ -18,6 +18,7 @@
 
 //#include <mpi.h>
 #include <math.h>
+#include <algorithm>
 
 #define DIS_DEBUG_OUTPUT false
 #define RUN_STD true
@@ -303,10 +304,61 @@ computeFunctionIndicesPerNode(
 
 
 
+// --------------------------------------------------------------------------
+// class DistributedMemoryAnalysisBase -- cost based assignment that keeps the traversal order
+// --------------------------------------------------------------------------
+template <class InheritedAttributeType>
+void
+DistributedMemoryAnalysisBase<InheritedAttributeType>::
+computeFunctionAssignment(SgNode *root, std::vector<int>& functionToProcessor,
+                          InheritedAttributeType rootInheritedValue,
+                          AstTopDownProcessing<InheritedAttributeType> *preTraversal)
+{
+    DistributedMemoryAnalysisPreTraversal<InheritedAttributeType> nodeCounter(preTraversal);
+    nodeCounter.traverse(root, rootInheritedValue);
+
+    funcDecls = nodeCounter.get_funcDecls();
+    initialInheritedValues = nodeCounter.get_initialInheritedValues();
+    myNodeCounts = nodeCounter.get_nodeCounts();
+    myFuncWeights = nodeCounter.get_funcWeights();
+    ROSE_ASSERT(funcDecls.size() == initialInheritedValues.size());
+    ROSE_ASSERT(funcDecls.size() == myNodeCounts.size());
+    ROSE_ASSERT(funcDecls.size() == myFuncWeights.size());
+
+    // same cost model as computeFunctionIndicesPerNode, but we sort an index instead of the functions themselves
+    std::vector<std::pair<double, size_t> > weights(funcDecls.size());
+    size_t totalNodes = 0;
+    for (size_t i = 0; i < funcDecls.size(); i++) {
+        weights[i].first = ((double)myNodeCounts[i]*myFuncWeights[i])/(double)funcDecls.size()/100;
+        weights[i].second = i;
+        totalNodes += myNodeCounts[i];
+    }
+    std::sort(weights.begin(), weights.end(), SortDescending());
+    nrOfNodes = totalNodes;
+
+    std::vector<double> processorWeight(processes, 0.0);
+    functionsPerProcess.assign(processes, 0);
+    functionToProcessor.assign(funcDecls.size(), (int)root_process);
+    for (size_t i = 0; i < weights.size(); i++) {
+        int min_rank = std::min_element(processorWeight.begin(), processorWeight.end()) - processorWeight.begin();
+        processorWeight[min_rank] += weights[i].first;
+        functionToProcessor[weights[i].second] = min_rank;
+        functionsPerProcess[min_rank]++;
+    }
+#if DIS_DEBUG_OUTPUT
+    for (int rank = 0; rank < processes; rank++)
+        std::cout << " Processor : " << rank << "  has " << functionsPerProcess[rank] <<
+            " functions. Processor weight: " << processorWeight[rank] << std::endl;
+#endif
+}
+
+
+
 // --------------------------------------------------------------------------
 // class DistributedMemoryTraversal
 // --------------------------------------------------------------------------
 
+#if ROSE_MPI
 
 template <class InheritedAttributeType, class SynthesizedAttributeType>
 void
@@ -509,6 +561,71 @@ performAnalysis(SgNode *root, InheritedAttributeType rootInheritedValue,
       delete[] myBuffer;
 }
 
+#else
+
+// Adapts the traversal to the local backend. The worker processes call the user's analyzeSubtree() and
+// serializeAttribute(); the root process deserializes the results.
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+class DistributedMemoryTraversal<InheritedAttributeType, SynthesizedAttributeType>::LocalJob
+  : public DistributedMemoryLocalProcesses::Job
+{
+public:
+    LocalJob(DistributedMemoryTraversal &traversal): traversal(traversal) {}
+
+    void enterProcess(int rank)
+    {
+        traversal.setMyID(rank);
+    }
+
+    std::pair<int, void *> analyzeFunction(size_t i)
+    {
+        SynthesizedAttributeType result =
+            traversal.analyzeSubtree(traversal.funcDecls[i], traversal.initialInheritedValues[i]);
+        return traversal.serializeAttribute(result);
+    }
+
+    void deleteSerializedResult(std::pair<int, void *> serialized)
+    {
+        traversal.deleteSerializedAttribute(serialized);
+    }
+
+private:
+    DistributedMemoryTraversal &traversal;
+};
+
+template <class InheritedAttributeType, class SynthesizedAttributeType>
+void
+DistributedMemoryTraversal<InheritedAttributeType, SynthesizedAttributeType>::
+performAnalysis(SgNode *root, InheritedAttributeType rootInheritedValue,
+                AstTopDownProcessing<InheritedAttributeType> *preTraversal,
+                AstBottomUpProcessing<SynthesizedAttributeType> *postTraversal)
+{
+    /* assign every function to a worker process according to its estimated cost */
+    std::vector<int> functionToProcess;
+    DistributedMemoryAnalysisBase<InheritedAttributeType>::computeFunctionAssignment(root, functionToProcess,
+                                                                                      rootInheritedValue, preTraversal);
+
+    /* run the analysis in the workers and collect the serialized results in the root process */
+    LocalJob job(*this);
+    std::vector<std::vector<unsigned char> > serializedResults;
+    DistributedMemoryLocalProcesses::run(job, functionToProcess, serializedResults);
+
+    /* unpack the serialized states (in traversal order) and store them away for the post traversal to use */
+    functionResults.clear();
+    for (size_t i = 0; i < serializedResults.size(); i++)
+    {
+        std::vector<unsigned char> &buffer = serializedResults[i];
+        std::pair<int, void *> serializedAttribute = std::make_pair((int)buffer.size(), buffer.empty() ? NULL : (void *) &buffer[0]);
+        functionResults.push_back(deserializeAttribute(serializedAttribute));
+    }
+
+    /* perform the post traversal */
+    DistributedMemoryAnalysisPostTraversal<SynthesizedAttributeType> postT(postTraversal, functionResults);
+    finalResults = postT.traverse(root, false);
+}
+
+#endif
+
 
 
 
@@ -2,7 +2,7 @@
 #ifndef PARALLEL_COMPASS_FUNCTIONLEVEL_H
 #define PARALLEL_COMPASS_FUNCTIONLEVEL_H
 
-// LOAD THIS FILE ONLY IF ROSE_MPI IS ENABLED
+// Works with both the MPI and the local multi-process backend
 #include <string>
 #include "DistributedMemoryAnalysis.h"
 
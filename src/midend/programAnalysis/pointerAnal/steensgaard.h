@@ -4,54 +4,101 @@
 /******Author: Qing Yi, Andrew Long 2007 ********/
 
 #include <union_find.h>
+#include <boost/unordered_map.hpp>
+#include <algorithm>
+#include <deque>
 #include <list>
 #include <map>
 #include <string>
+#include <vector>
 #include <iostream>
 #include <assert.h>
 
 #define BOT NULL
 
-class ECR;
-struct Lambda {
-   std::list<ECR *> inParams, outParams;
-   std::list<ECR*>& get_inParams() { return inParams; }
-   std::list<ECR*>& get_outParams() { return outParams; }
-}; ;
+// ECRs are dense ids into the arrays of an ECRmap.
+typedef size_t ECR;
+static const ECR NO_ECR = (ECR)(-1);   // the bottom type
 
-class ECR : public UF_elem
-{
-   ECR* type;
-   Lambda* lambda;
-   std::list<ECR *> pending;
-   ECR * find_group()
-    {  return static_cast<ECR*>(UF_elem::find_group()); }
+struct Lambda {
+   std::vector<ECR> inParams, outParams;
+   std::vector<ECR>& get_inParams() { return inParams; }
+   std::vector<ECR>& get_outParams() { return outParams; }
+};
 
+#define Variable std::string
 
-public:
-   ECR() : UF_elem(), type(BOT), lambda(BOT) {}
-   ~ECR() {}
+// Interned variables. Ids are dense, so per-variable data can live in arrays.
+typedef size_t VariableId;
+static const VariableId NO_VARIABLE = (VariableId)(-1);   // stands for the "" variable in argument lists
 
-   ECR * union_with(ECR *that) {
-                UF_elem::union_with(that);
-                return static_cast<ECR*>(UF_elem::find_group());
+// A buffered list of constraints, e.g. for one function. Buffers use their own variable ids and can therefore be
+// filled concurrently by different threads; ECRmap::solve merges them into the map one at a time. Since the result of
+// the unification does not depend on the order of the constraints, the buffers can be solved in any order.
+class SteensgaardConstraints {
+ public:
+   void x_eq_y(const Variable& x, const Variable& y) { add(X_EQ_Y, x, y); }
+   void x_eq_addr_y(const Variable& x, const Variable& y) { add(X_EQ_ADDR_Y, x, y); }
+   void x_eq_deref_y(const Variable& x, const Variable& y) { add(X_EQ_DEREF_Y, x, y); }
+   void deref_x_eq_y(const Variable& x, const Variable& y) { add(DEREF_X_EQ_Y, x, y); }
+   void allocate(const Variable& x) { add(ALLOCATE, x, ""); }
+   void x_eq_op_y(const Variable& x, const std::list<Variable>& y) {
+      add(X_EQ_OP_Y, x, "");
+      add_list(y);
+   }
+   void function_def_x(const Variable& x, const std::list<Variable>& inParams, const std::list<Variable>& outParams) {
+      add(FUNCTION_DEF_X, x, "");
+      add_list(inParams);
+      add_list(outParams);
+   }
+   void function_call_p(const Variable& p, const std::list<Variable>& x, const std::list<Variable>& y) {
+      add(FUNCTION_CALL_P, p, "");
+      add_list(x);
+      add_list(y);
    }
 
-   ECR* get_ecr()  { return find_group(); }
-   ECR* get_type() { 
-        ECR* g = find_group();
-        return (g->type)? g->type->find_group() : g->type;
-    }
-   void set_type(ECR *that) { 
-        ECR* g = find_group();
-        g->type = that;
+   size_t size() const { return constraints.size(); }
+   void clear() { constraints.clear(); lists.clear(); names.clear(); ids.clear(); }
+
+ private:
+   friend class ECRmap;
+   enum Kind { X_EQ_Y, X_EQ_ADDR_Y, X_EQ_DEREF_Y, DEREF_X_EQ_Y, ALLOCATE, X_EQ_OP_Y, FUNCTION_DEF_X, FUNCTION_CALL_P };
+   struct Constraint {
+      Kind kind;
+      VariableId x, y;
+      size_t list1, list2;              // indices into lists for the list arguments, if any
+   };
+   std::vector<Constraint> constraints;
+   std::vector<std::vector<VariableId> > lists;
+   std::vector<Variable> names;
+   boost::unordered_map<Variable, VariableId> ids;
+
+   VariableId intern(const Variable& x) {
+      if (x == "")
+         return NO_VARIABLE;
+      std::pair<boost::unordered_map<Variable, VariableId>::iterator, bool> inserted = ids.insert(std::make_pair(x, names.size()));
+      if (inserted.second)
+         names.push_back(x);
+      return inserted.first->second;
+   }
+   void add(Kind kind, const Variable& x, const Variable& y) {
+      Constraint c;
+      c.kind = kind;
+      c.x = intern(x);
+      c.y = intern(y);
+      c.list1 = c.list2 = 0;
+      constraints.push_back(c);
+   }
+   void add_list(const std::list<Variable>& vars) {
+      Constraint& c = constraints.back();
+      size_t& slot = c.list1 == 0 ? c.list1 : c.list2;  // one-based, zero means none
+      slot = lists.size() + 1;
+      lists.push_back(std::vector<VariableId>());
+      for (std::list<Variable>::const_iterator p = vars.begin(); p != vars.end(); ++p)
+         lists.back().push_back(intern(*p));
    }
-   std::list<ECR*>& get_pending() {return find_group()->pending;}
-   Lambda* get_lambda() { return lambda; }
-   void set_lambda(Lambda* l) { lambda = l; } 
 };
 
-#define Variable std::string
 class ECRmap {
  public:
    class VariableAlreadyDefined { 
@@ -60,88 +107,105 @@ class ECRmap {
          VariableAlreadyDefined(const Variable& _var) : var(_var) {}
    }; 
 
+   // The id of a variable, creating it if necessary
+   VariableId get_variable(const Variable& x) {
+      assert(x != "");
+      std::pair<boost::unordered_map<Variable, VariableId>::iterator, bool> inserted = table.insert(std::make_pair(x, vars.size()));
+      if (inserted.second) {
+         vars.push_back(new_ECR());
+         names.push_back(x);
+      }
+      return inserted.first->second;
+   }
+   size_t number_of_variables() const { return vars.size(); }
+
    // x = y
-   void x_eq_y(Variable x, Variable y) {
-      ECR* t1 = get_ECR(x)->get_type();
-      ECR* t2 = get_ECR(y)->get_type();
+   void x_eq_y(Variable x, Variable y) { x_eq_y(get_variable(x), get_variable(y)); }
+   void x_eq_y(VariableId x, VariableId y) {
+      ECR t1 = get_type(get_ECR(x));
+      ECR t2 = get_type(get_ECR(y));
       if (t1 != t2)
          cjoin(t1, t2);
    }
    // x = & y
-   void x_eq_addr_y(Variable x, Variable y) {
-      ECR * t1 = get_ECR(x)->get_type();
-      ECR * t2 = get_ECR(y);
+   void x_eq_addr_y(Variable x, Variable y) { x_eq_addr_y(get_variable(x), get_variable(y)); }
+   void x_eq_addr_y(VariableId x, VariableId y) {
+      ECR t1 = get_type(get_ECR(x));
+      ECR t2 = get_ECR(y);
       if (t1 != t2) {
          join(t1, t2);
       }
    }
    // x = *y
-   void x_eq_deref_y(Variable x, Variable y) {
-      ECR* t1 = get_ECR(x)->get_type();
-      ECR* t2 = get_ECR(y)->get_type();
-      if (t2->get_type() == BOT) {
-         set_type(t2, t1);
-      }
-      else {
-         ECR* t3 = t2->get_type();
-         if (t1 != t3)  {
-             cjoin(t1, t3);
-         }
-      }
+   void x_eq_deref_y(Variable x, Variable y) { x_eq_deref_y(get_variable(x), get_variable(y)); }
+   void x_eq_deref_y(VariableId x, VariableId y) {
+      ECR t1 = get_type(get_ECR(x));
+      ECR t2 = get_type(get_ECR(y));
+      if (get_type(t2) == NO_ECR)
+         set_type(t2, new_ECR());
+      ECR t3 = get_type(t2);
+      if (t1 != t3)
+         cjoin(t1, t3);
    }   
    // x = op(y1,...yn)
    void x_eq_op_y(Variable x, const std::list<Variable>& y) {
-      ECR* t1 = get_ECR(x)->get_type();
-      for (std::list<Variable>::const_iterator yp = y.begin();
+      x_eq_op_y(get_variable(x), get_variables(y));
+   }
+   void x_eq_op_y(VariableId x, const std::vector<VariableId>& y) {
+      ECR t1 = get_type(get_ECR(x));
+      for (std::vector<VariableId>::const_iterator yp = y.begin();
            yp != y.end(); ++yp) {
-         ECR* t2 = get_ECR(*yp)->get_type();
+         ECR t2 = get_type(get_ECR(*yp));
          if (t1 != t2) cjoin(t1, t2);
       }
    }
   // allocate(x)
-  void allocate(Variable x) {
-      ECR* t = get_ECR(x)->get_type();
-      if (t->get_type() == BOT) {
-          ECR* res = new_ECR();
+  void allocate(Variable x) { allocate(get_variable(x)); }
+  void allocate(VariableId x) {
+      ECR t = get_type(get_ECR(x));
+      if (get_type(t) == NO_ECR) {
+          ECR res = new_ECR();
           set_type(t,res);
       }
   }
   // *x = y
-  void deref_x_eq_y(Variable x, Variable y) {
-      ECR* t1 = get_ECR(x)->get_type();
-      ECR* t2 = get_ECR(y)->get_type();
-      if (t1->get_type() == BOT) {
-         set_type(t1, t2);
-      }
-      else {
-         ECR* t3 = t1->get_type();
-         if (t2 != t3) 
-             cjoin(t3, t2);
-      }
+  void deref_x_eq_y(Variable x, Variable y) { deref_x_eq_y(get_variable(x), get_variable(y)); }
+  void deref_x_eq_y(VariableId x, VariableId y) {
+      ECR t1 = get_type(get_ECR(x));
+      ECR t2 = get_type(get_ECR(y));
+      if (get_type(t1) == NO_ECR)
+         set_type(t1, new_ECR());
+      ECR t3 = get_type(t1);
+      if (t2 != t3) 
+         cjoin(t3, t2);
    }   
   // outParams = x (inparams)
   void function_def_x(Variable x, const std::list<Variable>& inParams, const std::list<Variable>& outParams) 
    {
-     ECR* t = get_ECR(x)->get_type();
-     Lambda* l = t->get_lambda();
+     function_def_x(get_variable(x), get_variables(inParams), get_variables(outParams));
+   }
+  void function_def_x(VariableId x, const std::vector<VariableId>& inParams, const std::vector<VariableId>& outParams) 
+   {
+     ECR t = get_type(get_ECR(x));
+     Lambda* l = get_lambda(t);
      if (l == BOT) {
         l = new_Lambda();
         set_lambda(l,inParams, outParams);
-        t->set_lambda(l);
+        lambdas[find(t)] = l;
      }
      else {
-       std::list<ECR *>::const_iterator p1=l->get_inParams().begin();
-       std::list<Variable>::const_iterator p2=inParams.begin();
+       std::vector<ECR>::const_iterator p1=l->get_inParams().begin();
+       std::vector<VariableId>::const_iterator p2=inParams.begin();
         for ( ; p1 != l->get_inParams().end(); ++p1,++p2) {
            assert(p2 != inParams.end());
-           join(*p1, get_ECR(*p2)->get_type());
+           join(*p1, get_type(get_ECR(*p2)));
         }
         assert(p2 == inParams.end());
         p1=l->get_outParams().begin();
         p2=outParams.begin();
         for ( ; p1 != l->get_outParams().end(); ++p1,++p2) {
            assert(p2 != outParams.end());
-           join(*p1, get_ECR(*p2)->get_type());
+           join(*p1, get_type(get_ECR(*p2)));
         }
         assert(p2 == outParams.end());
      } 
@@ -149,44 +213,71 @@ class ECRmap {
   // x = p (y)
   void function_call_p(Variable p, const std::list<Variable>& x, const std::list<Variable>& y)
   {
-     ECR* t = get_ECR(p)->get_type();
-     Lambda* l = t->get_lambda();
+     function_call_p(get_variable(p), get_variables(x), get_variables(y));
+  }
+  void function_call_p(VariableId p, const std::vector<VariableId>& x, const std::vector<VariableId>& y)
+  {
+     ECR t = get_type(get_ECR(p));
+     Lambda* l = get_lambda(t);
      if (l == BOT) {
         l = new_Lambda();
         set_lambda(l,y,x);
-        t->set_lambda(l);
+        lambdas[find(t)] = l;
      }
      else {
-       std::list<ECR *>::const_iterator p1=l->get_inParams().begin();
-       std::list<Variable>::const_iterator p2=y.begin();
+       std::vector<ECR>::const_iterator p1=l->get_inParams().begin();
+       std::vector<VariableId>::const_iterator p2=y.begin();
         for ( ; p1 != l->get_inParams().end(); ++p1,++p2) {
            assert(p2 != y.end());
-          ECR* cur = *p1;
-          assert(cur != 0);
-          Variable v2 = *p2;
-          if (v2 != "")
-             join(cur->get_ecr(), get_ECR(v2)->get_type());
+          if (*p2 != NO_VARIABLE)
+             join(*p1, get_type(get_ECR(*p2)));
         }
         assert(p2 == y.end());
         p1=l->get_outParams().begin();
         p2=x.begin();
         for ( ; p1 != l->get_outParams().end(); ++p1,++p2) {
            assert(p2 != x.end());
-           ECR* cur = *p1;
-          assert(cur != 0);
-          Variable v2 = *p2;
-           if ( v2 != "")
-           join(get_ECR(v2)->get_type(), cur->get_ecr());
+           if (*p2 != NO_VARIABLE)
+              join(get_type(get_ECR(*p2)), *p1);
         }
         assert(p2 == x.end());
      } 
   }
 
+  // Apply a buffer of constraints
+  void solve(const SteensgaardConstraints& c)
+  {
+     std::vector<VariableId> remap(c.names.size());
+     for (size_t i = 0; i < c.names.size(); ++i)
+        remap[i] = get_variable(c.names[i]);
+     for (std::vector<SteensgaardConstraints::Constraint>::const_iterator p = c.constraints.begin();
+          p != c.constraints.end(); ++p) {
+        VariableId x = p->x == NO_VARIABLE ? NO_VARIABLE : remap[p->x];
+        VariableId y = p->y == NO_VARIABLE ? NO_VARIABLE : remap[p->y];
+        switch (p->kind) {
+          case SteensgaardConstraints::X_EQ_Y: x_eq_y(x, y); break;
+          case SteensgaardConstraints::X_EQ_ADDR_Y: x_eq_addr_y(x, y); break;
+          case SteensgaardConstraints::X_EQ_DEREF_Y: x_eq_deref_y(x, y); break;
+          case SteensgaardConstraints::DEREF_X_EQ_Y: deref_x_eq_y(x, y); break;
+          case SteensgaardConstraints::ALLOCATE: allocate(x); break;
+          case SteensgaardConstraints::X_EQ_OP_Y:
+             x_eq_op_y(x, remap_list(c, p->list1, remap));
+             break;
+          case SteensgaardConstraints::FUNCTION_DEF_X:
+             function_def_x(x, remap_list(c, p->list1, remap), remap_list(c, p->list2, remap));
+             break;
+          case SteensgaardConstraints::FUNCTION_CALL_P:
+             function_call_p(x, remap_list(c, p->list1, remap), remap_list(c, p->list2, remap));
+             break;
+        }
+     }
+  }
+
   virtual void dump() { output(std::cerr); }
-  int find_LOC(std::ostream& out, std::map<ECR*, int>& locmap, int& loc, ECR* p)
+  int find_LOC(std::ostream& out, std::map<ECR, int>& locmap, int& loc, ECR p)
     {
               int cur = -1;
-              std::map<ECR*, int>::const_iterator p1 = locmap.find(p);
+              std::map<ECR, int>::const_iterator p1 = locmap.find(p);
               if (p1 == locmap.end()) {
                   locmap[p] = ++loc;
                   cur = loc;
@@ -195,46 +286,49 @@ class ECRmap {
                  cur = p1->second;
       return cur;
     }
-  void outputLOC(std::ostream& out, std::map<ECR*, int>& locmap, int& loc, ECR* p) {
+  void outputLOC(std::ostream& out, std::map<ECR, int>& locmap, int& loc, ECR p) {
       int max = 0;
       out << " LOC" << find_LOC(out,locmap,loc,p);
       for (;;) {
-        p = p->get_type();
-        if (p == 0) break;
+        p = get_type(p);
+        if (p == NO_ECR) break;
         int cur = find_LOC(out,locmap,loc,p);
         if (max < 0) break;
         else if (cur <= max) max = -1;
         else max = cur;
         out << "=>" << "LOC" << cur << " ";
-        if (p ->get_pending().size() != 0) {
+        const std::vector<ECR>& pending = pendings[find(p)];
+        if (pending.size() != 0) {
            out << "(pending ";
-           for (std::list<ECR*>::const_iterator pp=p->get_pending().begin(); 
-                pp != p->get_pending().end(); ++pp) 
-               outputLOC(out,locmap, loc, (*pp)->get_ecr());
+           for (std::vector<ECR>::const_iterator pp=pending.begin(); 
+                pp != pending.end(); ++pp) 
+               outputLOC(out,locmap, loc, find(*pp));
            out << ") ";
         }
-        Lambda* t = p->get_lambda();
+        Lambda* t = get_lambda(p);
         if (t != 0) {
            out << "(inparams: ";
-           for (std::list<ECR*>::const_iterator pp=t->get_inParams().begin(); 
+           for (std::vector<ECR>::const_iterator pp=t->get_inParams().begin(); 
                 pp != t->get_inParams().end(); ++pp) 
-              outputLOC(out,locmap,loc,(*pp)->get_ecr());
+              outputLOC(out,locmap,loc,find(*pp));
            out << ") ";
            out << "->(outparams: ";
-           for (std::list<ECR*>::const_iterator pp=t->get_outParams().begin(); 
+           for (std::vector<ECR>::const_iterator pp=t->get_outParams().begin(); 
                 pp != t->get_outParams().end(); ++pp)  
-              outputLOC(out,locmap,loc,(*pp)->get_ecr());
+              outputLOC(out,locmap,loc,find(*pp));
            out << ") ";
        }
     }
   }
 
   void output(std::ostream& out) {
-      std::map<ECR*, int> locmap;
+      std::map<ECR, int> locmap;
       int loc = 0;
-      for (std::map<Variable, ECR*>::iterator 
-           itMap = table.begin(); itMap != table.end(); itMap++) {
-           ECR* p = itMap->second->get_ecr();
+      std::vector<std::pair<Variable, VariableId> > sorted(table.begin(), table.end());
+      std::sort(sorted.begin(), sorted.end());
+      for (std::vector<std::pair<Variable, VariableId> >::iterator 
+           itMap = sorted.begin(); itMap != sorted.end(); itMap++) {
+           ECR p = find(vars[itMap->second]);
            out << itMap->first ;
            outputLOC(out,locmap,loc,p);
            out << "\n";
@@ -242,79 +336,111 @@ class ECRmap {
    }
 
    bool mayAlias(Variable x, Variable y) {
-      if (table.find(x) == table.end() || table.find(y) == table.end()) 
+      boost::unordered_map<Variable, VariableId>::const_iterator px = table.find(x), py = table.find(y);
+      if (px == table.end() || py == table.end()) 
          return false;     
-      
-      if (table[x]->get_type() == table[y]->get_type())
-         return true;
-      else
-         return false;
+      return mayAlias(px->second, py->second);
    }
-   virtual ~ECRmap() {
-      for (std::list<ECR*>::const_iterator p = ecrList.begin();
-           p != ecrList.end(); ++p) {
-          delete (*p);
-      }
+   bool mayAlias(VariableId x, VariableId y) {
+      return get_type(vars[x]) == get_type(vars[y]);
    }
+   virtual ~ECRmap() {}
 
  private:
-  std::map<Variable, ECR*> table;
-  std::list<ECR*> ecrList;
+  // Variables are interned: table maps a name to its id, vars and names are indexed by the id. ECRs are ids as well:
+  // the union-find and the type, lambda and pending list of each ECR are arrays indexed by the ECR. Only the entries of
+  // a group's representative are meaningful. Pending lists are kept in a deque so that adding an ECR does not copy them.
+  boost::unordered_map<Variable, VariableId> table;
+  std::vector<ECR> vars;
+  std::vector<Variable> names;
+  UF_array groups;
+  std::vector<ECR> types;
+  std::vector<Lambda*> lambdas;
+  std::deque<std::vector<ECR> > pendings;
   std::list<Lambda> lambdaList;
-  ECR* get_ECR(Variable x) {
-     assert(x != "");
-     std::map<Variable, ECR*>::const_iterator p = table.find(x);
-     ECR* res = 0;
-     if (p == table.end()) {
-        res = new_ECR();
-        table[x] = res;
-     }
-     else
-        res = (*p).second;
-     if (res->get_type() == 0) 
-         res->set_type(new_ECR());
+  ECR find(ECR e) { return groups.find_group(e); }
+  ECR get_type(ECR e) {
+     ECR t = types[find(e)];
+     return t == NO_ECR ? t : find(t);
+  }
+  Lambda* get_lambda(ECR e) { return lambdas[find(e)]; }
+  ECR get_ECR(VariableId x) {
+     assert(x != NO_VARIABLE && x < vars.size());
+     ECR res = vars[x];
+     if (get_type(res) == NO_ECR) 
+         set_type(res, new_ECR());
+     return res;
+  }
+  std::vector<VariableId> get_variables(const std::list<Variable>& vs) {
+     std::vector<VariableId> res;
+     res.reserve(vs.size());
+     for (std::list<Variable>::const_iterator p = vs.begin(); p != vs.end(); ++p)
+        res.push_back(*p == "" ? NO_VARIABLE : get_variable(*p));
+     return res;
+  }
+  static std::vector<VariableId> remap_list(const SteensgaardConstraints& c, size_t list,
+                                            const std::vector<VariableId>& remap) {
+     std::vector<VariableId> res;
+     if (list == 0)
+        return res;
+     const std::vector<VariableId>& vs = c.lists[list-1];
+     res.reserve(vs.size());
+     for (std::vector<VariableId>::const_iterator p = vs.begin(); p != vs.end(); ++p)
+        res.push_back(*p == NO_VARIABLE ? NO_VARIABLE : remap[*p]);
      return res;
   }
-  ECR* new_ECR() {
-     ecrList.push_back(new ECR());
-     return ecrList.back();
+  ECR new_ECR() {
+     types.push_back(NO_ECR);
+     lambdas.push_back(BOT);
+     pendings.push_back(std::vector<ECR>());
+     return groups.add();
   }
   Lambda* new_Lambda() {
      lambdaList.push_back(Lambda());
      return &lambdaList.back();
   }
-  void set_lambda(Lambda* l,const std::list<Variable>& inParams, const std::list<Variable>& outParams) {
-     for (std::list<Variable>::const_iterator p = inParams.begin();
+  void set_lambda(Lambda* l,const std::vector<VariableId>& inParams, const std::vector<VariableId>& outParams) {
+     for (std::vector<VariableId>::const_iterator p = inParams.begin();
           p != inParams.end(); ++p) {
-        Variable cur = *p;
-        if (cur != "")
-           l->get_inParams().push_back(get_ECR(cur)->get_type());
-        else l->get_inParams().push_back(0);
+        if (*p != NO_VARIABLE)
+           l->get_inParams().push_back(get_type(get_ECR(*p)));
+        else
+           l->get_inParams().push_back(new_ECR());
      }
-     for (std::list<Variable>::const_iterator p2 = outParams.begin();
+     for (std::vector<VariableId>::const_iterator p2 = outParams.begin();
           p2 != outParams.end(); ++p2) {
-        Variable cur = *p2;
-        if (cur != "")
-           l->get_outParams().push_back(get_ECR(cur)->get_type());
+        if (*p2 != NO_VARIABLE)
+           l->get_outParams().push_back(get_type(get_ECR(*p2)));
         else
            l->get_outParams().push_back(new_ECR());
      }
   }
-  void set_type(ECR * e, ECR * t) {
-      e->set_type(t);
-     assert(t != BOT && e->get_type() == t);
-      std::list<ECR*> pending = e->get_pending();
+  // Join e with everything on a pending list. The list is moved out first because the joins may add to it.
+  void join_pending(ECR e, std::vector<ECR>& pending) {
+      while (!pending.empty()) {
+         std::vector<ECR> work;
+         work.swap(pending);
+         for (std::vector<ECR>::const_iterator p=work.begin(); 
+              p != work.end(); ++p) 
+            join(e, *p);
+      }
+  }
+  void set_type(ECR e, ECR t) {
+      types[find(e)] = t;
+     assert(t != NO_ECR && get_type(e) == t);
+      std::vector<ECR> pending;
+      pending.swap(pendings[find(e)]);
       if (pending.size()) {
-         for (std::list<ECR*>::const_iterator p=pending.begin(); 
+         for (std::vector<ECR>::const_iterator p=pending.begin(); 
               p != pending.end(); ++p) 
-            join(t, *p);
-         e->get_pending().clear();
+            join(e, *p);
+         pendings[find(e)].clear();
       }
    }
    
-  void cjoin(ECR* e1, ECR* e2) {
-      if (e2->get_type() == BOT) {
-         e2->get_pending().push_back(e1);
+  void cjoin(ECR e1, ECR e2) {
+      if (get_type(e2) == NO_ECR) {
+         pendings[find(e2)].push_back(e1);
        }
       else
          join(e1, e2);
@@ -322,8 +448,8 @@ class ECRmap {
 
   void unify_lambda(Lambda* l1, Lambda* l2)
   {
-        std::list<ECR *>::const_iterator p1=l1->get_inParams().begin();
-        std::list<ECR *>::const_iterator p2=l2->get_inParams().begin();
+        std::vector<ECR>::const_iterator p1=l1->get_inParams().begin();
+        std::vector<ECR>::const_iterator p2=l2->get_inParams().begin();
         for ( ; p1 != l1->get_inParams().end(); ++p1,++p2) {
            assert(p2 != l2->get_inParams().end());
            join(*p1, *p2);
@@ -337,77 +463,41 @@ class ECRmap {
         }
         assert(p2 == l2->get_outParams().end());
    }
-  void unify(ECR * t1, ECR * t2) {
-     assert(t1 != 0 && t2 != 0);
-     Lambda* l1 = t1->get_lambda();
-     Lambda* l2 = t2->get_lambda();
-     if (l1 && l2) {
-        unify_lambda(l1,l2);
-     }
-     join(t1,t2);
-  }
-
-  void join(ECR * e1, ECR * e2) {
-      e1 = e1->get_ecr();
-      e2 = e2->get_ecr();
+  // Types and pending lists are merged before the lambdas are unified, since unifying the parameters may join this
+  // group again.
+  void join(ECR e1, ECR e2) {
+      e1 = find(e1);
+      e2 = find(e2);
       if (e1 == e2) return;
-      ECR* t1 = e1->get_type();
-      ECR* t2 = e2->get_type();
-      Lambda* l1 = e1->get_lambda();
-      Lambda* l2 = e2->get_lambda();
-      std::list<ECR*> *pending1 = &e1->get_pending(), *pending2 = &e2->get_pending();
-      ECR* e = e1->union_with(e2);
-      if (l1 == BOT) {
-         if (l2 != BOT) 
-           e->set_lambda(l2);
-      }
-      else {
-         e->set_lambda(l1);
-         if (l2 != BOT)
-            unify_lambda(l1,l2); 
-      }
-
-      std::list<ECR*> *pending = &e->get_pending();
+      ECR t1 = get_type(e1);
+      ECR t2 = get_type(e2);
+      Lambda* l1 = lambdas[e1];
+      Lambda* l2 = lambdas[e2];
+      std::vector<ECR> pending1, pending2;
+      pending1.swap(pendings[e1]);
+      pending2.swap(pendings[e2]);
+      ECR e = groups.union_with(e1, e2);
+      lambdas[e] = l1 != BOT ? l1 : l2;
  
-      if (t1 == BOT) {
-         e->set_type(t2);
-         if (t2 == BOT) {
-            if (e == e2) {
-               assert(pending != pending1);
-               pending->insert(pending->end(), pending1->begin(), pending1->end());
-            }
-            else if (e == e1) {
-              assert(pending != pending2);
-               pending->insert(pending->end(), pending2->begin(), pending2->end());
-            }
-            else {
-              assert(pending != pending2 && pending != pending1);
-               *pending = *pending1;
-               pending->insert(pending->end(), pending2->begin(), pending2->end());
-              }
+      if (t1 == NO_ECR) {
+         types[e] = t2;
+         if (t2 == NO_ECR) {
+            std::vector<ECR>& pending = pendings[e];
+            pending.insert(pending.end(), pending1.begin(), pending1.end());
+            pending.insert(pending.end(), pending2.begin(), pending2.end());
          }
-         else {
-           if (pending1->size()) {
-              for (std::list<ECR*>::const_iterator p=pending1->begin();
-                   p != pending1->end(); ++p) 
-                 join(e, *p);
-            }
-            pending->clear();
-        }
+         else
+            join_pending(e, pending1);
       }
       else {
-         e->set_type(t1);
-         if (t2 == BOT) {
-             if (pending2->size()) {
-               for (std::list<ECR*>::const_iterator p=pending2->begin();
-                    p != pending2->end(); ++p) 
-                  join(e, *p);
-             }
-         }
+         types[e] = t1;
+         if (t2 == NO_ECR)
+            join_pending(e, pending2);
          else
-            unify(t1, t2);
-         pending->clear();
+            join(t1, t2);
       }
+      if (l1 != BOT && l2 != BOT)
+         unify_lambda(l1, l2);
    }
 };
 
@@ -3,7 +3,7 @@
 #define DEP_INFO_ANAL
 
 #include <map>
-//#include <vector>
+#include <vector>
 #include <DepInfo.h>
 #include <DomainInfo.h>
 #include <FunctionObject.h>
@@ -13,6 +13,54 @@
 
 extern bool DebugDep();
 
+// Memoizes the results of AdhocDependenceTesting. The key is the normalized
+// relation matrix built from the subscripts of the two references, together
+// with the loop bounds, the statement domains, the dependence type and the
+// common loop level. References in different statements that produce the same
+// key (e.g., the many similar references of a stencil) are tested only once.
+// A result is only cached if it did not need the bounds of other symbolic
+// variables, since those depend on where the references are. Each
+// DepInfoAnal owns a cache, so entries never outlive the analysis that
+// computed them.
+class DepTestCache
+{
+ public:
+  struct Entry {
+     bool none;                 // the test found no dependence
+     bool precise;
+     int rows, cols;
+     std::vector<DepRel> rels;  // rows x cols, row major
+     Entry() : none(true), precise(false), rows(0), cols(0) {}
+  };
+
+  DepTestCache() : hits(0), misses(0), uncached(0) {}
+  ~DepTestCache();
+
+  // Returns the cached entry for key, or 0 if there is none. Counts a hit or a miss.
+  const Entry* Lookup(const std::string& key);
+  void Insert(const std::string& key, const Entry& e) { table[key] = e; }
+  // Counts a test whose result could not be cached.
+  void CountUncached() { ++uncached; }
+  void Clear() { table.clear(); }
+
+  size_t NumOfEntries() const { return table.size(); }
+  size_t NumOfHits() const { return hits; }
+  size_t NumOfMisses() const { return misses; }
+  size_t NumOfUncached() const { return uncached; }
+  double HitRate() const 
+    { return (hits + misses + uncached == 0)? 0 : (double)hits / (hits + misses + uncached); }
+  std::string toString() const;
+
+  // Counts of all the caches that have been destroyed so far
+  static size_t TotalHits() { return totalHits; }
+  static size_t TotalMisses() { return totalMisses; }
+  static size_t TotalUncached() { return totalUncached; }
+ private:
+  std::map <std::string, Entry, std::less<std::string> > table;
+  size_t hits, misses, uncached;
+  static size_t totalHits, totalMisses, totalUncached;
+};
+
 class DependenceTesting;
 class DepInfoAnal 
 {
@@ -72,9 +120,23 @@ class DepInfoAnal
 
   AstInterface& get_astInterface() { return varmodInfo.get_astInterface(); }
 
+  // Side effects of a statement as found by AnalyzeStmtRefs. They are
+  // collected once per statement; every pair the statement takes part in
+  // reuses them.
+  struct StmtRefInfoSet {
+     bool succ;
+     std::vector<AstNodePtr> wRefs, rRefs;
+     StmtRefInfoSet() : succ(false) {}
+  };
+  const StmtRefInfoSet& GetStmtRefs(const AstNodePtr& s);
+
+  DepTestCache& GetDepTestCache() { return depTestCache; }
+
  private:
         DependenceTesting& handle;
         std::map <AstNodePtr, LoopDepInfo, std::less <AstNodePtr> > stmtInfo;
+        std::map <AstNodePtr, StmtRefInfoSet, std::less <AstNodePtr> > stmtRefs;
+        DepTestCache depTestCache;
         ModifyVariableInfo varmodInfo;
 };
 
@@ -239,6 +301,7 @@ class MakeUniqueVarGetBound
   typedef MakeUniqueVar::ReverseRecMap ReverseRecMap;
   typedef MakeUniqueVar::ReverseRec ReverseRec;
   ReverseRecMap &reverse;
+  size_t queries;
   void VisitVar( const SymbolicVar& var)
   {
           result = GetBound(var);
@@ -246,9 +309,12 @@ class MakeUniqueVarGetBound
  public:
    MakeUniqueVarGetBound( ReverseRecMap& r1, DepInfoAnal& a) 
      : SymbolicConstBoundAnalysis<AstNodePtr, DepInfoAnalInterface>(DepInfoAnalInterface(a),AST_NULL,AST_NULL),
-       reverse(r1) {} 
+       reverse(r1), queries(0) {} 
+  // Number of variable bounds looked up so far
+  size_t NumOfQueries() const { return queries; }
   SymbolicBound GetBound(const SymbolicVar& var)
    {
+      ++queries;
       ReverseRec& entry = reverse[var.GetVarName()];
       node = entry.second;
       assert(node != AST_NULL);
@@ -134,6 +134,8 @@ class Transaction;
 class TransactionImpl;
 class Statement;
 class StatementImpl;
+class BatchWriter;
+class BatchWriterImpl;
 
 /** Smart pointer to a database connection.  Database connections are always referenced through their smart pointers and are
  *  automatically deleted when all references disappear. See Connection::create(). */
@@ -147,6 +149,10 @@ typedef boost::shared_ptr<Transaction> TransactionPtr;
  *  automatically deleted when all references disappear. See Transaction::statement(). */
 typedef boost::shared_ptr<Statement> StatementPtr;
 
+/** Smart pointer to a batch writer.  Batch writers are always referenced through their smart pointers and are
+ *  automatically deleted when all references disappear. See Transaction::batch_writer(). */
+typedef boost::shared_ptr<BatchWriter> BatchWriterPtr;
+
 // Data type used in templates to indicate lack of a column
 class NoColumn {};
 
@@ -191,6 +197,7 @@ class Connection: public boost::enable_shared_from_this<Connection> {
     friend class TransactionImpl;
     friend class Transaction;
     friend class StatementImpl;
+    friend class BatchWriterImpl;
 public:
     /** Create a new database connection.  All connection objects are bound to a database throughout their lifetime, although
      * depending on the driver, the actual low-level connection may open and close. The @p open_spec string describes how to
@@ -259,6 +266,7 @@ class Transaction: public boost::enable_shared_from_this<Transaction> {
     friend class ConnectionImpl;
     friend class Statement;
     friend class StatementImpl;
+    friend class BatchWriterImpl;
 public:
     /** Create a new transaction.  Transactions can be created either by this class method or by calling
      *  Connection::transaction().  The transaction will exist until there are no references (user or statements).
@@ -292,6 +300,9 @@ public:
      *  in the table. Some drivers require that a bulk load is the only operation performed in a transaction. */
     void bulk_load(const std::string &tablename, std::istream&);
 
+    /** Create a batch writer that inserts rows with @p ncolumns columns into the specified table.  See BatchWriter::create(). */
+    BatchWriterPtr batch_writer(const std::string &tablename, size_t ncolumns, size_t batch_size=10000);
+
     /** Returns the low-level driver name for this transaction. */
     Driver driver() const;
 
@@ -446,6 +457,109 @@ template<> uint32_t Statement::iterator::get<uint32_t>(size_t idx);
 template<> float Statement::iterator::get<float>(size_t idx);
 template<> double Statement::iterator::get<double>(size_t idx);
 template<> std::string Statement::iterator::get<std::string>(size_t idx);
+
+/*******************************************************************************************************************************
+ *                                      Batch writers
+ *******************************************************************************************************************************/
+
+/** Buffered insertion of many rows into one table.  Inserting rows one at a time with Statement::bind() and
+ *  Statement::execute() costs one statement preparation and one server round trip per row, and bulk_load() requires that
+ *  the caller first format every value as comma-separated text.  A batch writer instead appends typed values to an
+ *  in-memory row buffer and writes the buffer to the database each time it holds @p batch_size rows:
+ *
+ *  <ul>
+ *    <li>SQLite3 batches are written with multi-row "insert into T values (?,...),(?,...),..." statements which are
+ *        prepared once and to which the values are bound with their native types.</li>
+ *    <li>PostgreSQL batches are streamed through the COPY protocol.</li>
+ *  </ul>
+ *
+ *  Values are added one column at a time with add(), and a row is complete once @p ncolumns values have been added. The
+ *  add() methods return the writer so that calls can be chained:
+ *
+ * @code
+ *  SqlDatabase::BatchWriterPtr writer = tx->batch_writer("semantic_fio", 3);
+ *  for (size_t i=0; i<tests.size(); ++i)
+ *      writer->add(tests[i].func_id)->add(tests[i].igroup_id)->add(tests[i].status);
+ *  writer->finish();
+ *  std::cerr <<"inserted " <<writer->nrows() <<" rows at " <<writer->rate() <<" rows/s\n";
+ *  tx->commit();
+ * @endcode
+ *
+ *  If the background property is set then each full batch is written by a separate thread while the caller fills the next
+ *  batch.  The transaction's low-level connection is not thread safe, so the transaction must not be used for anything
+ *  else until flush() or finish() returns.  An error encountered by the background thread is thrown as an Exception by the
+ *  next call to add(), flush(), or finish().
+ *
+ *  Rows that are still buffered when the writer is destroyed are discarded; call finish() to write them. */
+class BatchWriter: public boost::enable_shared_from_this<BatchWriter> {
+public:
+    /** Create a new batch writer.  Batch writers can be created either by this class method or by calling
+     *  Transaction::batch_writer().  The table must exist and have exactly @p ncolumns columns. */
+    static BatchWriterPtr create(const TransactionPtr &tranx, const std::string &tablename, size_t ncolumns,
+                                 size_t batch_size=10000) {
+        return BatchWriterPtr(new BatchWriter(tranx, tablename, ncolumns, batch_size));
+    }
+
+    /** Append a value to the current row.  The row is queued for insertion once all of its columns have values, and the
+     *  buffered rows are written when there are @p batch_size of them.
+     * @{ */
+    BatchWriterPtr add(int32_t val);
+    BatchWriterPtr add(int64_t val);
+    BatchWriterPtr add(uint32_t val);
+    BatchWriterPtr add(uint64_t val);
+    BatchWriterPtr add(double val);
+    BatchWriterPtr add(const std::string &val);
+    /** @} */
+
+    /** Write all complete rows that are buffered.  It is an error to flush while a row is only partially added. */
+    void flush();
+
+    /** Write the remaining rows.  The transaction can be used for other statements after this returns, and the writer
+     *  can still be used to add more rows. */
+    void finish();
+
+    /** Background writing property.  If set, full batches are written by a background thread.
+     * @{ */
+    void set_background(bool);
+    bool get_background() const;
+    /** @} */
+
+    /** Returns the number of rows that have been written to the database.  The statistics can be queried while a background
+     *  thread is writing a batch. */
+    size_t nrows() const;
+
+    /** Returns the number of seconds elapsed between creation of this writer and the end of its most recent write. */
+    double elapsed() const;
+
+    /** Returns the number of rows written per second. */
+    double rate() const;
+
+    /** Returns the table into which rows are inserted. */
+    std::string tablename() const;
+
+    /** Returns the transaction for this writer. */
+    TransactionPtr transaction() const;
+
+    /** Print some basic info about this writer, including the insertion rate. */
+    void print(std::ostream&) const;
+
+public:
+    // Called only by boost::shared_ptr
+    ~BatchWriter() { finish_impl(); }
+
+protected:
+    BatchWriter(const TransactionPtr &tranx, const std::string &tablename, size_t ncolumns, size_t batch_size)
+        : impl(NULL) {
+        init(tranx, tablename, ncolumns, batch_size);
+    }
+
+private:
+    void init(const TransactionPtr &tranx, const std::string &tablename, size_t ncolumns, size_t batch_size);
+    void finish_impl();
+
+private:
+    BatchWriterImpl *impl;
+};
     
 /*******************************************************************************************************************************
  *                                      Miscellaneous functions
@@ -496,6 +610,7 @@ std::ostream& operator<<(std::ostream&, const Exception&);
 std::ostream& operator<<(std::ostream&, const Connection&);
 std::ostream& operator<<(std::ostream&, const Transaction&);
 std::ostream& operator<<(std::ostream&, const Statement&);
+std::ostream& operator<<(std::ostream&, const BatchWriter&);
 
 /*******************************************************************************************************************************
  *                                      Tables
@@ -19,6 +19,7 @@
 #include <boost/logic/tribool.hpp>
 #include <cassert>
 #include <cstring>
+#include <istream>
 #include <list>
 #include <ostream>
 #include <set>
@@ -483,6 +484,7 @@ typedef SharedPointer<class FdSink> FdSinkPtr;
 typedef SharedPointer<class FileSink> FileSinkPtr;
 typedef SharedPointer<class StreamSink> StreamSinkPtr;
 typedef SharedPointer<class SyslogSink> SyslogSinkPtr;
+typedef SharedPointer<class AsyncSink> AsyncSinkPtr;
 /** @} */
 
 /** Baked properties for a destination.  Rather than recompute properties every time characters of a message are inserted into
@@ -1341,6 +1343,178 @@ private:
 };
 #endif
 
+/** Sends messages to their final destination from a background thread.
+ *
+ *  Sinks such as FdSink and FileSink format and write each message in the thread that posts it while holding the sink's
+ *  mutex, which serializes all threads that emit diagnostics and makes high-volume output (such as enabling DEBUG or TRACE
+ *  streams) very slow.  An asynchronous sink instead copies each completed message into a fixed-size ring that belongs to the
+ *  posting thread and returns immediately. A writer thread owned by the sink drains all the rings and, in the order in which
+ *  the messages were posted by all threads, either forwards them to a target destination (which formats them as usual) or
+ *  appends them to a binary log.
+ *
+ *  Each ring has a single producer (the posting thread) and a single consumer (the writer thread). When compiled with GCC,
+ *  each thread also caches its rings of the eight sinks it posted to most recently, so posting a message takes no locks
+ *  unless the sink is not in the thread's cache (such as the first time the thread posts to it). Other compilers take a lock
+ *  for every message.  Only completed and canceled messages are queued; the sink's default properties request buffered
+ *  output so streams don't post partial messages to it at all.  When a thread's ring is full the posting thread either waits
+ *  for the writer to make room or drops the message, depending on the @ref overflow property.
+ *
+ *  The binary log format is much cheaper to produce than formatted text since no prefixes, colors, or gang coordination are
+ *  necessary.  It records the time at which each message was posted, the posting thread, the facility name, the importance,
+ *  and the text. Times never decrease from one record to the next: if two threads read the clock in the opposite order from
+ *  which they posted, the later message is given the earlier message's time.  A BinaryLogReader reads such a log and formats
+ *  its records much like a FileSink would have done.
+ *
+ * @code
+ *  // Send diagnostics to standard error from a background thread
+ *  Facility mlog("analysis", AsyncSink::instance(FileSink::instance(stderr)));
+ *
+ *  // Keep tracing enabled in production runs by writing it to a binary log
+ *  int fd = open("trace.log", O_WRONLY|O_CREAT|O_TRUNC, 0666);
+ *  Facility tlog("analysis", AsyncSink::binaryInstance(fd)->overflow(AsyncSink::DROP_ON_OVERFLOW));
+ * @endcode
+ *
+ *  Messages posted to a sink that forwards to a target are formatted by the writer thread, therefore a message's prefix shows
+ *  the time at which it was written rather than posted. Messages are flushed and the writer thread is joined when the sink
+ *  is destroyed, or flushed explicitly by calling @ref flush.  If multi-threading is disabled then messages are written
+ *  synchronously.
+ *
+ *  Thread safety: This object is thread-safe except where noted. */
+class SAWYER_EXPORT AsyncSink: public Destination {
+public:
+    /** What to do when a thread's ring is full. */
+    enum Overflow {
+        BLOCK_ON_OVERFLOW,                              /**< Wait until the writer thread makes room. */
+        DROP_ON_OVERFLOW                                /**< Discard the message and count it. */
+    };
+
+private:
+    class Ring;                                         // per-thread queue of messages
+#include <sawyer/WarningsOff.h>
+    DestinationPtr target_;                             // destination for formatted output, or null for a binary log
+    int fd_;                                            // file descriptor for the binary log, or -1
+    size_t ringCapacity_;                               // number of messages per thread ring
+    Overflow overflow_;                                 // what to do when a ring is full
+    unsigned serial_;                                   // unique ID used by the per-thread ring cache
+    std::vector<Ring*> rings_;                          // rings in the order their threads first posted; protected by ringsMutex_
+    volatile size_t nextSequence_;                      // sequence number for the next posted message
+    volatile size_t nDropped_;                          // number of messages dropped because a ring was full
+    bool stopRequested_;                                // writer should drain the rings and exit; protected by ringsMutex_
+#if SAWYER_MULTI_THREADED
+    mutable boost::mutex ringsMutex_;                   // protects rings_ and stopRequested_
+    boost::condition_variable wakeup_;                  // signaled to wake the writer
+    boost::condition_variable drained_;                 // signaled by the writer after each pass
+    boost::thread writer_;                              // drains the rings
+#endif
+#include <sawyer/WarningsRestore.h>
+
+protected:
+    /** Constructor for derived classes. Non-subclass users should use @ref instance or @ref binaryInstance instead. */
+    AsyncSink(const DestinationPtr &target, int fd, size_t ringCapacity);
+public:
+    /** Flushes all queued messages and joins the writer thread. The binary log file descriptor is not closed. */
+    ~AsyncSink();
+
+    /** Allocating constructor.  Constructs a new sink that forwards messages to the specified destination from a writer
+     *  thread. Each posting thread gets a ring that holds up to @p ringCapacity messages. */
+    static AsyncSinkPtr instance(const DestinationPtr &target, size_t ringCapacity = 4096) {
+        return AsyncSinkPtr(new AsyncSink(target, -1, ringCapacity));
+    }
+
+    /** Allocating constructor.  Constructs a new sink that appends messages in binary format to the specified Unix file
+     *  descriptor from a writer thread.  The log header is written immediately. Each posting thread gets a ring that holds
+     *  up to @p ringCapacity messages. */
+    static AsyncSinkPtr binaryInstance(int fd, size_t ringCapacity = 4096) {
+        return AsyncSinkPtr(new AsyncSink(DestinationPtr(), fd, ringCapacity));
+    }
+
+    virtual void post(const Mesg&, const MesgProps&) /*override*/;
+
+    /** Property: what to do when a thread's ring is full.
+     *
+     *  The default is to block until the writer thread makes room.
+     *
+     *  Thread safety: This method is thread-safe.
+     *
+     * @{ */
+    Overflow overflow() const;
+    AsyncSinkPtr overflow(Overflow);
+    /** @} */
+
+    /** Number of messages dropped because a ring was full.
+     *
+     *  Thread safety: This method is thread-safe. */
+    size_t nDropped() const;
+
+    /** Wait for all messages posted so far to be written.
+     *
+     *  Messages posted concurrently with this call might or might not be written before it returns.
+     *
+     *  Thread safety: This method is thread-safe. */
+    void flush();
+
+private:
+    void init();
+    Ring* localRing();
+    void writerMain();
+    bool hasPendingNS() const;
+    void emit(const Mesg&, const MesgProps&, double time, unsigned thread, std::string &binaryBuffer);
+    void writeBinary(const std::string&);
+};
+
+/** One message read from a binary log.
+ *
+ *  See AsyncSink::binaryInstance and BinaryLogReader. */
+struct SAWYER_EXPORT BinaryLogRecord {
+#include <sawyer/WarningsOff.h>
+    double time;                                        /**< Time at which the message was posted, seconds since the epoch.
+                                                         *   Never less than the time of the previous record. */
+    unsigned thread;                                    /**< Posting thread, numbered from zero by the sink. */
+    unsigned mesgId;                                    /**< Message ID. See Mesg::id. */
+    Optional<Importance> importance;                    /**< Message importance, if it had one. */
+    std::string facilityName;                           /**< Name of the facility, or empty. */
+    std::string text;                                   /**< Message text. */
+    bool isCanceled;                                    /**< True if the message was canceled rather than completed. */
+#include <sawyer/WarningsRestore.h>
+
+    BinaryLogRecord(): time(0.0), thread(0), mesgId(0), isCanceled(false) {}
+};
+
+/** Reads a binary log written by an AsyncSink.
+ *
+ *  The log header is read by the constructor, after which @ref next returns the records in the order they were written.
+ *
+ *  Thread safety: This object is not thread-safe. */
+class SAWYER_EXPORT BinaryLogReader {
+    std::istream &in_;
+#include <sawyer/WarningsOff.h>
+    std::string programName_;
+#include <sawyer/WarningsRestore.h>
+    unsigned pid_;
+    double startTime_;
+public:
+    /** Constructs a reader and reads the log header. Throws an <code>std::runtime_error</code> if the stream does not
+     *  contain a binary log written by this version of the library. */
+    explicit BinaryLogReader(std::istream&);
+
+    /** Name of the program that wrote the log. */
+    const std::string& programName() const { return programName_; }
+
+    /** Process ID of the program that wrote the log. */
+    unsigned pid() const { return pid_; }
+
+    /** Time at which the program that wrote the log started, in seconds since the epoch. */
+    double startTime() const { return startTime_; }
+
+    /** Read the next record.  Returns false at the end of the log. Throws an <code>std::runtime_error</code> if the log is
+     *  truncated or corrupt. */
+    bool next(BinaryLogRecord&);
+
+    /** Format a record as a line of text.  The line has the same prefix as a default FileSink would have emitted, plus
+     *  the number of the posting thread, and ends with a linefeed. */
+    std::string toString(const BinaryLogRecord&) const;
+};
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Message streams
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
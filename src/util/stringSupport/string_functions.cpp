@@ -539,6 +539,42 @@ StringUtility::cEscape(const std::string &s) {
     return result;
 }
 
+std::string
+StringUtility::jsonString(const std::string &s) {
+    std::string retval = "\"";
+    for (size_t i=0; i<s.size(); ++i) {
+        switch (s[i]) {
+            case '"':  retval += "\\\""; break;
+            case '\\': retval += "\\\\"; break;
+            case '\n': retval += "\\n";  break;
+            case '\t': retval += "\\t";  break;
+            default:
+                if ((unsigned char)s[i] < 0x20) {
+                    char buf[8];
+                    sprintf(buf, "\\u%04x", (unsigned)(unsigned char)s[i]);
+                    retval += buf;
+                } else {
+                    retval += s[i];
+                }
+                break;
+        }
+    }
+    return retval + "\"";
+}
+
+std::string
+StringUtility::csvString(const std::string &s) {
+    if (s.find_first_of(",\"\n") == std::string::npos)
+        return s;
+    std::string retval = "\"";
+    for (size_t i=0; i<s.size(); ++i) {
+        if (s[i] == '"')
+            retval += '"';
+        retval += s[i];
+    }
+    return retval + "\"";
+}
+
 unsigned
 StringUtility::hexadecimalToInt(char ch) {
     if (isxdigit(ch)) {
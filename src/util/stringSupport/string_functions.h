@@ -445,6 +445,12 @@ namespace StringUtility
    /** Escape as for C/C++ string literals. */
    ROSE_UTIL_API std::string cEscape(const std::string&);
 
+   /** Quoted JSON string.  Quotes, backslashes, and control characters are escaped. */
+   ROSE_UTIL_API std::string jsonString(const std::string&);
+
+   /** CSV field.  A string containing a comma, a quote, or a newline is quoted, with its quotes doubled. */
+   ROSE_UTIL_API std::string csvString(const std::string&);
+
     // DQ (2/3/2009): Moved this function from attach_all_info.C
        ROSE_UTIL_API std::vector<std::string> readWordsInFile( std::string filename);
 
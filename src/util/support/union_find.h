@@ -4,6 +4,7 @@
 #define UNION_FIND_h
 
 #include <stdlib.h>
+#include <vector>
 
 class UF_elem 
 {
@@ -34,16 +35,70 @@ class UF_elem
          p1->size += p2->size;
        }
      } 
+   // Iterative with full path compression, so that long chains built up on large inputs do not
+   // exhaust the stack.
    UF_elem * find_group()
    {
-     if (this->p_group == this->p_group->p_group)
-       return this->p_group;
-     
-     p_group = p_group->find_group();
-     return p_group;
+     UF_elem *root = this;
+     while (root->p_group != root)
+       root = root->p_group;
+     for (UF_elem *p = this; p->p_group != root; ) {
+       UF_elem *next = p->p_group;
+       p->p_group = root;
+       p = next;
+     }
+     return root;
    }
    unsigned group_size() const { return size; }
 };
 
-#endif
+// Union-find over dense ids 0, 1, 2, ... with union by rank and path compression. The parents and ranks
+// are kept in arrays indexed by the id, so adding an element does not allocate a node of its own.
+class UF_array
+{
+   std::vector<size_t> parent;
+   std::vector<unsigned char> rank;
+ public:
+   // Adds an element in a group of its own and returns its id.
+   size_t add()
+     {
+       parent.push_back(parent.size());
+       rank.push_back(0);
+       return parent.size() - 1;
+     }
+   size_t size() const { return parent.size(); }
+
+   bool in_same_group(size_t x, size_t y)
+     {
+       return find_group(x) == find_group(y);
+     }
+   // Returns the id of the representative of the merged group.
+   size_t union_with(size_t x, size_t y)
+     {
+       size_t r1 = find_group(x), r2 = find_group(y);
+       if (r1 == r2) return r1;
 
+       if (rank[r1] < rank[r2]) {
+         parent[r1] = r2;
+         return r2;
+       }
+       parent[r2] = r1;
+       if (rank[r1] == rank[r2])
+         ++rank[r1];
+       return r1;
+     }
+   size_t find_group(size_t x)
+   {
+     size_t root = x;
+     while (parent[root] != root)
+       root = parent[root];
+     while (parent[x] != root) {
+       size_t next = parent[x];
+       parent[x] = root;
+       x = next;
+     }
+     return root;
+   }
+};
+
+#endif
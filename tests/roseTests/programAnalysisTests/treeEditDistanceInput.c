@@ -0,0 +1,59 @@
+/* Functions for the tree edit distance test: some are small edits of others, and some are very different. */
+
+int sum(int *a, int n)
+{
+  int i, s = 0;
+  for (i = 0; i < n; ++i)
+    s += a[i];
+  return s;
+}
+
+int sumSquares(int *a, int n)
+{
+  int i, s = 0;
+  for (i = 0; i < n; ++i)
+    s += a[i] * a[i];
+  return s;
+}
+
+int sumWhile(int *a, int n)
+{
+  int i = 0, s = 0;
+  while (i < n)
+    s += a[i++];
+  return s;
+}
+
+int maximum(int *a, int n)
+{
+  int i, m = a[0];
+  for (i = 1; i < n; ++i) {
+    if (a[i] > m)
+      m = a[i];
+  }
+  return m;
+}
+
+int identity(int x)
+{
+  return x;
+}
+
+int negate(int x)
+{
+  return -x;
+}
+
+void sort(int *a, int n)
+{
+  int i, j, t;
+  for (i = 0; i < n; ++i) {
+    for (j = i + 1; j < n; ++j) {
+      if (a[j] < a[i]) {
+        t = a[i];
+        a[i] = a[j];
+        a[j] = t;
+      }
+    }
+  }
+}